@@ -0,0 +1,28 @@
+#!/bin/bash
+# Scaling comparison of the shared-memory backends: ./scaling.sh N "W1 W2 ..."
+# Prints the wavefront time of each backend for each number of workers
+N=${1:-4096}
+WORKERS=${2:-"1 2 4 8 16 32"}
+
+make -s wavefront_pf_cache wavefront_farm || exit 1
+
+# Oversubscribed runs measure the scheduler of the OS, not the backends: record the machine
+# with the results and flag the worker counts it cannot run in parallel
+CORES=$(nproc)
+echo "# $(uname -n), $CORES cores, $(grep -m1 'model name' /proc/cpuinfo | cut -d: -f2 | sed 's/^ //'), N=$N"
+
+time_of(){
+    "$@" | grep "Time passed to calculate the wavefront" | awk '{print $NF}'
+}
+
+printf "%4s %14s %14s %14s %14s\n" W pf_cache pf_adaptive pf_steal farm
+for W in $WORKERS; do
+    if [ "$W" -ge "$CORES" ]; then
+        echo "# W=$W: the farm needs W+1 threads on $CORES cores, the next row is not scaling data"
+    fi
+    printf "%4s %14s %14s %14s %14s\n" $W \
+        "$(time_of ./wavefront_pf_cache $N $W)" \
+        "$(time_of ./wavefront_pf_cache $N $W --schedule=adaptive)" \
+        "$(time_of ./wavefront_pf_cache $N $W --backend=steal --schedule=adaptive)" \
+        "$(time_of ./wavefront_farm $N $W)"
+done
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <cstdint>
+#if defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+#endif
+
+#include "matrix.hpp"
+
+namespace wavefront{
+
+/*!
+    \name SpinBarrier
+    \brief Sense-reversing barrier for a fixed set of threads
+    \note The last thread to arrive resets the counter and flips the global sense, the others wait
+          for the sense to match their own: first spinning with pause, then yielding, then sleeping
+          in std::atomic::wait (a futex on Linux). Each thread keeps its own sense, initially false
+*/
+class SpinBarrier{
+public:
+    explicit SpinBarrier(uint32_t threads) : threads(threads), waiting(threads) {}
+
+    void Wait(bool &local_sense){
+        local_sense = !local_sense;
+        const uint32_t target = local_sense;
+        if(waiting.fetch_sub(1, std::memory_order_acq_rel) == 1){
+            // Last one in: release everybody else
+            waiting.store(threads, std::memory_order_relaxed);
+            sense.store(target, std::memory_order_release);
+            sense.notify_all();
+            return;
+        }
+        for(uint32_t i = 0; sense.load(std::memory_order_acquire) != target; i++){
+            if(i < kSpin){
+                Pause();
+            } else if(i < kSpin + kYield){
+                std::this_thread::yield();
+            } else {
+                sense.wait(!target, std::memory_order_acquire);
+            }
+        }
+    }
+
+private:
+    static constexpr uint32_t kSpin = 1 << 10;     // Polls with pause before yielding
+    static constexpr uint32_t kYield = 1 << 6;     // Polls with yield before sleeping
+
+    static void Pause(){
+    #if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+    #endif
+    }
+
+    const uint32_t threads;
+    alignas(kCacheLine) std::atomic<uint32_t> waiting;
+    alignas(kCacheLine) std::atomic<uint32_t> sense{0};
+};
+
+} // namespace wavefront
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+#include "kernels.hpp"
+
+namespace wavefront{
+
+#if defined(WAVEFRONT_X86)
+/*!
+    \name Cbrt4
+    \param x 4 doubles
+    \brief Cube root of 4 doubles with AVX2/FMA
+    \note fdlibm scheme: exponent/3 bit trick for ~5 bits, a polynomial in t^3/x up to 23 bits,
+          rounding to 23 bits and one Halley step to full double precision (< 0.67 ulp).
+          Only valid for normal numbers, the caller handles zero, subnormals, inf and NaN
+*/
+WAVEFRONT_TARGET("avx2,fma") inline __m256d Cbrt4(__m256d x){
+    const __m256d sign_mask = _mm256_set1_pd(-0.0);
+    __m256d sign = _mm256_and_pd(x, sign_mask);
+    __m256d ax = _mm256_andnot_pd(sign_mask, x);
+
+    // Initial guess: high word (exponent and leading mantissa bits) divided by 3, hi*0xAAAAAAAB >> 33 == hi/3
+    __m256i hi = _mm256_srli_epi64(_mm256_castpd_si256(ax), 32);
+    __m256i third = _mm256_srli_epi64(_mm256_mul_epu32(hi, _mm256_set1_epi64x(0xAAAAAAABLL)), 33);
+    __m256d t = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_add_epi64(third, _mm256_set1_epi64x(0x2A9F7893LL)), 32));
+
+    // cbrt(x) = t*cbrt(x/t^3) ~= t*P(t^3/x), good to 23 bits
+    __m256d r = _mm256_mul_pd(_mm256_mul_pd(t, t), _mm256_div_pd(t, ax));
+    __m256d p_low = _mm256_fmadd_pd(r, _mm256_fmadd_pd(r, _mm256_set1_pd(1.621429720105354466140), _mm256_set1_pd(-1.88497979543377169875)),
+                                    _mm256_set1_pd(1.87595182427177009643));
+    __m256d p_high = _mm256_fmadd_pd(r, _mm256_set1_pd(0.145996192886612446982), _mm256_set1_pd(-0.758397934778766047437));
+    t = _mm256_mul_pd(t, _mm256_fmadd_pd(_mm256_mul_pd(_mm256_mul_pd(r, r), r), p_high, p_low));
+
+    // Round t away from zero to 23 bits so that t*t is exact
+    __m256i bits = _mm256_add_epi64(_mm256_castpd_si256(t), _mm256_set1_epi64x(0x80000000LL));
+    t = _mm256_castsi256_pd(_mm256_and_si256(bits, _mm256_set1_epi64x(static_cast<long long>(0xFFFFFFFFC0000000ULL))));
+
+    // One Halley step to 53 bits: t += t*(x/t^2 - t)/(2t + x/t^2)
+    __m256d s = _mm256_mul_pd(t, t);
+    r = _mm256_div_pd(ax, s);
+    __m256d w = _mm256_add_pd(t, t);
+    r = _mm256_div_pd(_mm256_sub_pd(r, t), _mm256_add_pd(w, r));
+    t = _mm256_fmadd_pd(t, r, t);
+
+    return _mm256_or_pd(t, sign);
+}
+
+/*!
+    \name CbrtAvx2
+    \brief In-place cube root of a buffer, 4 doubles at a time
+*/
+WAVEFRONT_TARGET("avx2,fma") inline void CbrtAvx2(double *x, std::size_t n){
+    std::size_t j = 0;
+    for(; j + 4 <= n; j += 4){
+        __m256d v = _mm256_loadu_pd(x + j);
+        // Zero, subnormals, inf and NaN have an all-zero or all-one exponent
+        __m256i hi = _mm256_srli_epi64(_mm256_castpd_si256(v), 32);
+        hi = _mm256_and_si256(hi, _mm256_set1_epi64x(0x7FFFFFFFLL));
+        __m256i special = _mm256_or_si256(_mm256_cmpgt_epi64(_mm256_set1_epi64x(0x00100000LL), hi),
+                                          _mm256_cmpgt_epi64(hi, _mm256_set1_epi64x(0x7FEFFFFFLL)));
+        __m256d result = Cbrt4(v);
+        if(_mm256_testz_si256(special, special)){
+            _mm256_storeu_pd(x + j, result);
+        } else {
+            double values[4];
+            _mm256_storeu_pd(values, v);
+            _mm256_storeu_pd(x + j, result);
+            for(std::size_t l = 0; l < 4; l++){
+                if(!std::isnormal(values[l])){
+                    x[j+l] = std::cbrt(values[l]);
+                }
+            }
+        }
+    }
+    for(; j < n; j++){
+        x[j] = std::cbrt(x[j]);
+    }
+}
+
+/*!
+    \name CbrtAvx2
+    \brief In-place cube root of a buffer of floats, widened to double 4 at a time
+*/
+WAVEFRONT_TARGET("avx2,fma") inline void CbrtAvx2(float *x, std::size_t n){
+    std::size_t j = 0;
+    for(; j + 4 <= n; j += 4){
+        __m128 v = _mm_loadu_ps(x + j);
+        // Every normal float is a normal double, only zero, inf and NaN need the slow path
+        __m128 magnitude = _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+        __m128 special = _mm_or_ps(_mm_cmpeq_ps(magnitude, _mm_setzero_ps()), _mm_cmpunord_ps(v, v));
+        special = _mm_or_ps(special, _mm_cmpeq_ps(magnitude, _mm_set1_ps(INFINITY)));
+        __m128 result = _mm256_cvtpd_ps(Cbrt4(_mm256_cvtps_pd(v)));
+        if(_mm_movemask_ps(special) == 0){
+            _mm_storeu_ps(x + j, result);
+        } else {
+            float values[4];
+            _mm_storeu_ps(values, v);
+            _mm_storeu_ps(x + j, result);
+            for(std::size_t l = 0; l < 4; l++){
+                if(!std::isnormal(values[l])){
+                    x[j+l] = std::cbrt(values[l]);
+                }
+            }
+        }
+    }
+    for(; j < n; j++){
+        x[j] = std::cbrt(x[j]);
+    }
+}
+#endif
+
+/*!
+    \name CbrtBatch
+    \param x buffer, overwritten with its cube roots
+    \param n number of elements
+    \brief Cube root of a whole buffer
+    \note SIMD version when the CPU has AVX2/FMA (and WAVEFRONT_ISA does not force a lower ISA),
+          std::cbrt otherwise
+*/
+template <typename T>
+inline void CbrtBatch(T *x, std::size_t n){
+#if defined(WAVEFRONT_X86)
+    if(DispatchDot::Selected() >= DispatchDot::kAvx2){
+        CbrtAvx2(x, n);
+        return;
+    }
+#endif
+    for(std::size_t j = 0; j < n; j++){
+        x[j] = std::cbrt(x[j]);
+    }
+}
+
+/*!
+    \name BatchCbrt
+    \brief Dot-product strategy adapter: the dot products of a diagonal range are collected in a
+           buffer and their cube roots are taken together with CbrtBatch
+    \note e.g. ComputeDiagonal<BatchCbrt<DefaultDot>>(M, k, m_begin, m_end)
+*/
+template <typename Dot>
+struct BatchCbrt : Dot{
+    static constexpr bool kBatchCbrt = true;
+};
+
+} // namespace wavefront
@@ -0,0 +1,590 @@
+#pragma once
+
+#include <string>
+#include <cstdlib>
+#include <cstddef>
+#include <algorithm>
+#if defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+    #define WAVEFRONT_X86
+    // Build a kernel for the given ISA whatever the flags of the translation unit are
+    #define WAVEFRONT_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace wavefront{
+
+// Diagonals accumulated in registers before a block of the output is written back
+constexpr std::size_t kSweepDepth = 16;
+
+/*!
+    \name SweepDiagonalGeneric
+    \brief Register-blocked sweep of a diagonal-major block, out[j] = sum_i D_i[block+j] * D_{k-1-i}[block+j+i+1]
+    \note Diagonal d starts at data + offsets[d]. kSweepWidth consecutive elements of the diagonal are kept
+          in an accumulator array (registers once vectorised by the compiler) over kSweepDepth diagonals
+          before being written back, instead of a load/store of out for every i. Always inlined, so it
+          is vectorised for the ISA of the calling kernel
+*/
+template <typename T>
+__attribute__((always_inline)) inline void SweepDiagonalGeneric(T *out, const T *data, const std::size_t *offsets,
+                                                                std::size_t k, std::size_t block, std::size_t len){
+    constexpr std::size_t kSweepWidth = 16;
+    for(std::size_t i0 = 0; i0 < k; i0 += kSweepDepth){
+        std::size_t i1 = std::min(k, i0 + kSweepDepth);
+        std::size_t j = 0;
+        for(; j + kSweepWidth <= len; j += kSweepWidth){
+            T acc[kSweepWidth];
+            for(std::size_t l = 0; l < kSweepWidth; l++){
+                acc[l] = i0 ? out[j+l] : T(0);
+            }
+            for(std::size_t i = i0; i < i1; i++){
+                const T *a = data + offsets[i] + block + j;
+                const T *b = data + offsets[k-1-i] + block + j + i + 1;
+                for(std::size_t l = 0; l < kSweepWidth; l++){
+                    acc[l] += a[l] * b[l];
+                }
+            }
+            for(std::size_t l = 0; l < kSweepWidth; l++){
+                out[j+l] = acc[l];
+            }
+        }
+        for(; j < len; j++){
+            T acc = i0 ? out[j] : T(0);
+            for(std::size_t i = i0; i < i1; i++){
+                acc += data[offsets[i] + block + j] * data[offsets[k-1-i] + block + j + i + 1];
+            }
+            out[j] = acc;
+        }
+    }
+}
+
+/*!
+    \name ScalarDot
+    \brief Plain dot product, one element at a time
+    \note Also used for the layouts without a contiguous column operand (stride != 1)
+*/
+struct ScalarDot{
+    static constexpr bool kBatchCbrt = false;
+
+    template <typename T>
+    static T Compute(const T *a, const T *b, std::size_t n, std::size_t stride = 1){
+        T sum = T(0);
+        for(std::size_t i = 0; i < n; i++){
+            sum += a[i] * b[i*stride];
+        }
+        return sum;
+    }
+
+    // out[j] = sum_i D_i[block+j] * D_{k-1-i}[block+j+i+1], diagonal d at data + offsets[d]
+    template <typename T>
+    static void SweepDiagonal(T *out, const T *data, const std::size_t *offsets, std::size_t k, std::size_t block, std::size_t len){
+        SweepDiagonalGeneric(out, data, offsets, k, block, len);
+    }
+};
+
+#if defined(WAVEFRONT_X86)
+/*!
+    \name Sse2Dot
+    \brief Dot product using SSE2
+    \note SSE2 128 bits - 2 doubles or 4 floats at a time, two accumulators, scalar remainder
+*/
+struct Sse2Dot{
+    static constexpr bool kBatchCbrt = false;
+
+    WAVEFRONT_TARGET("sse2") static double Compute(const double *a, const double *b, std::size_t n){
+        std::size_t i = 0;
+        __m128d acc0 = _mm_setzero_pd();
+        __m128d acc1 = _mm_setzero_pd();
+        for(; i + 4 <= n; i += 4){
+            acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+            acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+        }
+        __m128d sum_128 = _mm_add_pd(acc0, acc1);
+        sum_128 = _mm_add_sd(sum_128, _mm_unpackhi_pd(sum_128, sum_128));
+        double element = _mm_cvtsd_f64(sum_128);
+        for(; i < n; i++){
+            element += a[i] * b[i];
+        }
+        return element;
+    }
+
+    WAVEFRONT_TARGET("sse2") static float Compute(const float *a, const float *b, std::size_t n){
+        std::size_t i = 0;
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps();
+        for(; i + 8 <= n; i += 8){
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+        }
+        __m128 sum_128 = _mm_add_ps(acc0, acc1);
+        sum_128 = _mm_add_ps(sum_128, _mm_movehl_ps(sum_128, sum_128));               // [a+c, b+d, ...]
+        sum_128 = _mm_add_ss(sum_128, _mm_shuffle_ps(sum_128, sum_128, 1));          // [a+c+b+d, ...]
+        float element = _mm_cvtss_f32(sum_128);
+        for(; i < n; i++){
+            element += a[i] * b[i];
+        }
+        return element;
+    }
+
+
+    WAVEFRONT_TARGET("sse2") static void SweepDiagonal(double *out, const double *data, const std::size_t *offsets,
+                                              std::size_t k, std::size_t block, std::size_t len){
+        SweepDiagonalGeneric(out, data, offsets, k, block, len);
+    }
+
+    WAVEFRONT_TARGET("sse2") static void SweepDiagonal(float *out, const float *data, const std::size_t *offsets,
+                                              std::size_t k, std::size_t block, std::size_t len){
+        SweepDiagonalGeneric(out, data, offsets, k, block, len);
+    }
+};
+
+/*!
+    \name AvxDot
+    \brief Dot product using AVX
+    \note AVX 256 bits - 4 doubles or 8 floats at a time, scalar loop for the remainder
+*/
+struct AvxDot{
+    static constexpr bool kBatchCbrt = false;
+
+    WAVEFRONT_TARGET("avx") static double Compute(const double *a, const double *b, std::size_t n){
+        double element = 0.0;
+        std::size_t i = 0;
+        // Initialize sum_vec to zero
+        __m256d sum_vec = _mm256_setzero_pd();
+        // Process 4 elements at a time
+        for(; i + 4 <= n; i += 4){
+            __m256d vec1 = _mm256_loadu_pd(a + i);                      // Load 4 elements from the row
+            __m256d vec2 = _mm256_loadu_pd(b + i);                      // Load 4 elements from the column_transpose
+            __m256d prod = _mm256_mul_pd(vec1, vec2);                   // Multiply the two vectors -> prod = [a*b, c*d, e*f, g*h]
+            sum_vec = _mm256_add_pd(sum_vec, prod);                     // Move the results to the sum_vector
+        }
+        // Extract the sum from the vector
+        __m128d sum_high = _mm256_extractf128_pd(sum_vec, 1);           // Extract the last 128 bits - Latency 3 cycles - Throughput 1 cycle
+        __m128d sum_low = _mm256_castpd256_pd128(sum_vec);              // Take the first 128 bits without cost - Latency 1 cycle
+        __m128d sum_128 = _mm_add_pd(sum_low, sum_high);                // [a, b] + [c, d] -> [a+c, b+d]
+        sum_128 = _mm_hadd_pd(sum_128, sum_128);                        // Horizontal add -> [a+c+b+d, a+c+b+d]
+        double sum;
+        _mm_store_sd(&sum, sum_128);                                    // Store the result in a double
+        element += sum;
+
+        // Process the elements out of the block of 4
+        for(; i < n; i++){
+            element += a[i] * b[i];
+        }
+        return element;
+    }
+
+    WAVEFRONT_TARGET("avx") static float Compute(const float *a, const float *b, std::size_t n){
+        float element = 0.0f;
+        std::size_t i = 0;
+        __m256 sum_vec = _mm256_setzero_ps();
+        // Process 8 elements at a time
+        for(; i + 8 <= n; i += 8){
+            __m256 vec1 = _mm256_loadu_ps(a + i);                       // Load 8 elements from the row
+            __m256 vec2 = _mm256_loadu_ps(b + i);                       // Load 8 elements from the column_transpose
+            __m256 prod = _mm256_mul_ps(vec1, vec2);
+            sum_vec = _mm256_add_ps(sum_vec, prod);
+        }
+        __m128 sum_high = _mm256_extractf128_ps(sum_vec, 1);            // Extract the last 128 bits
+        __m128 sum_low = _mm256_castps256_ps128(sum_vec);               // Take the first 128 bits without cost
+        __m128 sum_128 = _mm_add_ps(sum_low, sum_high);                 // [a, b, c, d] + [e, f, g, h] -> [a+e, b+f, c+g, d+h]
+        sum_128 = _mm_hadd_ps(sum_128, sum_128);                        // Horizontal add -> [a+e+b+f, c+g+d+h, ...]
+        sum_128 = _mm_hadd_ps(sum_128, sum_128);                        // Horizontal add -> [a+b+c+d+e+f+g+h, ...]
+        float sum;
+        _mm_store_ss(&sum, sum_128);                                    // Store the result in a float
+        element += sum;
+
+        // Process the elements out of the block of 8
+        for(; i < n; i++){
+            element += a[i] * b[i];
+        }
+        return element;
+    }
+
+
+    WAVEFRONT_TARGET("avx") static void SweepDiagonal(double *out, const double *data, const std::size_t *offsets,
+                                              std::size_t k, std::size_t block, std::size_t len){
+        SweepDiagonalGeneric(out, data, offsets, k, block, len);
+    }
+
+    WAVEFRONT_TARGET("avx") static void SweepDiagonal(float *out, const float *data, const std::size_t *offsets,
+                                              std::size_t k, std::size_t block, std::size_t len){
+        SweepDiagonalGeneric(out, data, offsets, k, block, len);
+    }
+};
+
+/*!
+    \name Avx2FmaDot
+    \brief Dot product using AVX2 and FMA
+    \note Four independent accumulators over an unrolled loop hide the FMA latency, the remainder
+          is handled with a masked load instead of a scalar loop
+*/
+struct Avx2FmaDot{
+    static constexpr bool kBatchCbrt = false;
+
+    // Lanes [0, n) of the mask are set
+    WAVEFRONT_TARGET("avx2,fma") static __m256i TailMask64(std::size_t n){
+        return _mm256_cmpgt_epi64(_mm256_set1_epi64x(n), _mm256_setr_epi64x(0, 1, 2, 3));
+    }
+    WAVEFRONT_TARGET("avx2,fma") static __m256i TailMask32(std::size_t n){
+        return _mm256_cmpgt_epi32(_mm256_set1_epi32(n), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    }
+
+    WAVEFRONT_TARGET("avx2,fma") static double Compute(const double *a, const double *b, std::size_t n){
+        std::size_t i = 0;
+        __m256d acc0 = _mm256_setzero_pd();
+        __m256d acc1 = _mm256_setzero_pd();
+        __m256d acc2 = _mm256_setzero_pd();
+        __m256d acc3 = _mm256_setzero_pd();
+        // Process 16 elements at a time
+        for(; i + 16 <= n; i += 16){
+            acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc0);
+            acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), acc1);
+            acc2 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 8), _mm256_loadu_pd(b + i + 8), acc2);
+            acc3 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12), acc3);
+        }
+        // Process 4 elements at a time
+        for(; i + 4 <= n; i += 4){
+            acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc0);
+        }
+        // Masked tail, lanes past n are loaded as zero
+        if(i < n){
+            __m256i mask = TailMask64(n - i);
+            acc1 = _mm256_fmadd_pd(_mm256_maskload_pd(a + i, mask), _mm256_maskload_pd(b + i, mask), acc1);
+        }
+        __m256d sum_vec = _mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3));
+        __m128d sum_128 = _mm_add_pd(_mm256_castpd256_pd128(sum_vec), _mm256_extractf128_pd(sum_vec, 1));
+        sum_128 = _mm_hadd_pd(sum_128, sum_128);
+        return _mm_cvtsd_f64(sum_128);
+    }
+
+    WAVEFRONT_TARGET("avx2,fma") static float Compute(const float *a, const float *b, std::size_t n){
+        std::size_t i = 0;
+        __m256 acc0 = _mm256_setzero_ps();
+        __m256 acc1 = _mm256_setzero_ps();
+        __m256 acc2 = _mm256_setzero_ps();
+        __m256 acc3 = _mm256_setzero_ps();
+        // Process 32 elements at a time
+        for(; i + 32 <= n; i += 32){
+            acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+            acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+            acc2 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 16), _mm256_loadu_ps(b + i + 16), acc2);
+            acc3 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 24), _mm256_loadu_ps(b + i + 24), acc3);
+        }
+        // Process 8 elements at a time
+        for(; i + 8 <= n; i += 8){
+            acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        }
+        // Masked tail, lanes past n are loaded as zero
+        if(i < n){
+            __m256i mask = TailMask32(n - i);
+            acc1 = _mm256_fmadd_ps(_mm256_maskload_ps(a + i, mask), _mm256_maskload_ps(b + i, mask), acc1);
+        }
+        __m256 sum_vec = _mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3));
+        __m128 sum_128 = _mm_add_ps(_mm256_castps256_ps128(sum_vec), _mm256_extractf128_ps(sum_vec, 1));
+        sum_128 = _mm_hadd_ps(sum_128, sum_128);
+        sum_128 = _mm_hadd_ps(sum_128, sum_128);
+        return _mm_cvtss_f32(sum_128);
+    }
+
+    // Register-blocked sweep: 4 vectors of the diagonal stay in registers over kSweepDepth diagonals
+    WAVEFRONT_TARGET("avx2,fma") static void SweepDiagonal(double *out, const double *data, const std::size_t *offsets,
+                                                    std::size_t k, std::size_t block, std::size_t len){
+        for(std::size_t i0 = 0; i0 < k; i0 += kSweepDepth){
+            std::size_t i1 = std::min(k, i0 + kSweepDepth);
+            std::size_t j = 0;
+            for(; j + 16 <= len; j += 16){
+                __m256d acc0 = i0 ? _mm256_loadu_pd(out + j) : _mm256_setzero_pd();
+                __m256d acc1 = i0 ? _mm256_loadu_pd(out + j + 4) : _mm256_setzero_pd();
+                __m256d acc2 = i0 ? _mm256_loadu_pd(out + j + 8) : _mm256_setzero_pd();
+                __m256d acc3 = i0 ? _mm256_loadu_pd(out + j + 12) : _mm256_setzero_pd();
+                for(std::size_t i = i0; i < i1; i++){
+                    const double *a = data + offsets[i] + block + j;
+                    const double *b = data + offsets[k-1-i] + block + j + i + 1;
+                    acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b), acc0);
+                    acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + 4), _mm256_loadu_pd(b + 4), acc1);
+                    acc2 = _mm256_fmadd_pd(_mm256_loadu_pd(a + 8), _mm256_loadu_pd(b + 8), acc2);
+                    acc3 = _mm256_fmadd_pd(_mm256_loadu_pd(a + 12), _mm256_loadu_pd(b + 12), acc3);
+                }
+                _mm256_storeu_pd(out + j, acc0);
+                _mm256_storeu_pd(out + j + 4, acc1);
+                _mm256_storeu_pd(out + j + 8, acc2);
+                _mm256_storeu_pd(out + j + 12, acc3);
+            }
+            // Masked tail, one vector at a time
+            for(; j < len; j += 4){
+                __m256i mask = TailMask64(len - j);
+                __m256d acc = i0 ? _mm256_maskload_pd(out + j, mask) : _mm256_setzero_pd();
+                for(std::size_t i = i0; i < i1; i++){
+                    const double *a = data + offsets[i] + block + j;
+                    const double *b = data + offsets[k-1-i] + block + j + i + 1;
+                    acc = _mm256_fmadd_pd(_mm256_maskload_pd(a, mask), _mm256_maskload_pd(b, mask), acc);
+                }
+                _mm256_maskstore_pd(out + j, mask, acc);
+            }
+        }
+    }
+
+    WAVEFRONT_TARGET("avx2,fma") static void SweepDiagonal(float *out, const float *data, const std::size_t *offsets,
+                                                    std::size_t k, std::size_t block, std::size_t len){
+        for(std::size_t i0 = 0; i0 < k; i0 += kSweepDepth){
+            std::size_t i1 = std::min(k, i0 + kSweepDepth);
+            std::size_t j = 0;
+            for(; j + 32 <= len; j += 32){
+                __m256 acc0 = i0 ? _mm256_loadu_ps(out + j) : _mm256_setzero_ps();
+                __m256 acc1 = i0 ? _mm256_loadu_ps(out + j + 8) : _mm256_setzero_ps();
+                __m256 acc2 = i0 ? _mm256_loadu_ps(out + j + 16) : _mm256_setzero_ps();
+                __m256 acc3 = i0 ? _mm256_loadu_ps(out + j + 24) : _mm256_setzero_ps();
+                for(std::size_t i = i0; i < i1; i++){
+                    const float *a = data + offsets[i] + block + j;
+                    const float *b = data + offsets[k-1-i] + block + j + i + 1;
+                    acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a), _mm256_loadu_ps(b), acc0);
+                    acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + 8), _mm256_loadu_ps(b + 8), acc1);
+                    acc2 = _mm256_fmadd_ps(_mm256_loadu_ps(a + 16), _mm256_loadu_ps(b + 16), acc2);
+                    acc3 = _mm256_fmadd_ps(_mm256_loadu_ps(a + 24), _mm256_loadu_ps(b + 24), acc3);
+                }
+                _mm256_storeu_ps(out + j, acc0);
+                _mm256_storeu_ps(out + j + 8, acc1);
+                _mm256_storeu_ps(out + j + 16, acc2);
+                _mm256_storeu_ps(out + j + 24, acc3);
+            }
+            // Masked tail, one vector at a time
+            for(; j < len; j += 8){
+                __m256i mask = TailMask32(len - j);
+                __m256 acc = i0 ? _mm256_maskload_ps(out + j, mask) : _mm256_setzero_ps();
+                for(std::size_t i = i0; i < i1; i++){
+                    const float *a = data + offsets[i] + block + j;
+                    const float *b = data + offsets[k-1-i] + block + j + i + 1;
+                    acc = _mm256_fmadd_ps(_mm256_maskload_ps(a, mask), _mm256_maskload_ps(b, mask), acc);
+                }
+                _mm256_maskstore_ps(out + j, mask, acc);
+            }
+        }
+    }
+
+};
+
+/*!
+    \name Avx512Dot
+    \brief Dot product using AVX-512
+    \note AVX-512 512 bits - four accumulators of 8 doubles or 16 floats, masked tail
+*/
+struct Avx512Dot{
+    static constexpr bool kBatchCbrt = false;
+
+    WAVEFRONT_TARGET("avx512f") static double Compute(const double *a, const double *b, std::size_t n){
+        std::size_t i = 0;
+        __m512d acc0 = _mm512_setzero_pd();
+        __m512d acc1 = _mm512_setzero_pd();
+        __m512d acc2 = _mm512_setzero_pd();
+        __m512d acc3 = _mm512_setzero_pd();
+        // Process 32 elements at a time
+        for(; i + 32 <= n; i += 32){
+            acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), acc0);
+            acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8), acc1);
+            acc2 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 16), _mm512_loadu_pd(b + i + 16), acc2);
+            acc3 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 24), _mm512_loadu_pd(b + i + 24), acc3);
+        }
+        // Process 8 elements at a time
+        for(; i + 8 <= n; i += 8){
+            acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), acc0);
+        }
+        // Masked tail, lanes past n are loaded as zero
+        if(i < n){
+            __mmask8 mask = static_cast<__mmask8>((1u << (n - i)) - 1);
+            acc1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, a + i), _mm512_maskz_loadu_pd(mask, b + i), acc1);
+        }
+        return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3)));
+    }
+
+    WAVEFRONT_TARGET("avx512f") static float Compute(const float *a, const float *b, std::size_t n){
+        std::size_t i = 0;
+        __m512 acc0 = _mm512_setzero_ps();
+        __m512 acc1 = _mm512_setzero_ps();
+        __m512 acc2 = _mm512_setzero_ps();
+        __m512 acc3 = _mm512_setzero_ps();
+        // Process 64 elements at a time
+        for(; i + 64 <= n; i += 64){
+            acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+            acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), acc1);
+            acc2 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 32), _mm512_loadu_ps(b + i + 32), acc2);
+            acc3 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 48), _mm512_loadu_ps(b + i + 48), acc3);
+        }
+        // Process 16 elements at a time
+        for(; i + 16 <= n; i += 16){
+            acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+        }
+        // Masked tail, lanes past n are loaded as zero
+        if(i < n){
+            __mmask16 mask = static_cast<__mmask16>((1u << (n - i)) - 1);
+            acc1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i), acc1);
+        }
+        return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(acc0, acc1), _mm512_add_ps(acc2, acc3)));
+    }
+
+
+    WAVEFRONT_TARGET("avx512f") static void SweepDiagonal(double *out, const double *data, const std::size_t *offsets,
+                                                    std::size_t k, std::size_t block, std::size_t len){
+        for(std::size_t i0 = 0; i0 < k; i0 += kSweepDepth){
+            std::size_t i1 = std::min(k, i0 + kSweepDepth);
+            std::size_t j = 0;
+            for(; j + 32 <= len; j += 32){
+                __m512d acc0 = i0 ? _mm512_loadu_pd(out + j) : _mm512_setzero_pd();
+                __m512d acc1 = i0 ? _mm512_loadu_pd(out + j + 8) : _mm512_setzero_pd();
+                __m512d acc2 = i0 ? _mm512_loadu_pd(out + j + 16) : _mm512_setzero_pd();
+                __m512d acc3 = i0 ? _mm512_loadu_pd(out + j + 24) : _mm512_setzero_pd();
+                for(std::size_t i = i0; i < i1; i++){
+                    const double *a = data + offsets[i] + block + j;
+                    const double *b = data + offsets[k-1-i] + block + j + i + 1;
+                    acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(a), _mm512_loadu_pd(b), acc0);
+                    acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + 8), _mm512_loadu_pd(b + 8), acc1);
+                    acc2 = _mm512_fmadd_pd(_mm512_loadu_pd(a + 16), _mm512_loadu_pd(b + 16), acc2);
+                    acc3 = _mm512_fmadd_pd(_mm512_loadu_pd(a + 24), _mm512_loadu_pd(b + 24), acc3);
+                }
+                _mm512_storeu_pd(out + j, acc0);
+                _mm512_storeu_pd(out + j + 8, acc1);
+                _mm512_storeu_pd(out + j + 16, acc2);
+                _mm512_storeu_pd(out + j + 24, acc3);
+            }
+            // Masked tail, one vector at a time
+            for(; j < len; j += 8){
+                __mmask8 mask = static_cast<__mmask8>(len - j >= 8 ? 0xFF : (1u << (len - j)) - 1);
+                __m512d acc = i0 ? _mm512_maskz_loadu_pd(mask, out + j) : _mm512_setzero_pd();
+                for(std::size_t i = i0; i < i1; i++){
+                    const double *a = data + offsets[i] + block + j;
+                    const double *b = data + offsets[k-1-i] + block + j + i + 1;
+                    acc = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, a), _mm512_maskz_loadu_pd(mask, b), acc);
+                }
+                _mm512_mask_storeu_pd(out + j, mask, acc);
+            }
+        }
+    }
+
+    WAVEFRONT_TARGET("avx512f") static void SweepDiagonal(float *out, const float *data, const std::size_t *offsets,
+                                                    std::size_t k, std::size_t block, std::size_t len){
+        for(std::size_t i0 = 0; i0 < k; i0 += kSweepDepth){
+            std::size_t i1 = std::min(k, i0 + kSweepDepth);
+            std::size_t j = 0;
+            for(; j + 64 <= len; j += 64){
+                __m512 acc0 = i0 ? _mm512_loadu_ps(out + j) : _mm512_setzero_ps();
+                __m512 acc1 = i0 ? _mm512_loadu_ps(out + j + 16) : _mm512_setzero_ps();
+                __m512 acc2 = i0 ? _mm512_loadu_ps(out + j + 32) : _mm512_setzero_ps();
+                __m512 acc3 = i0 ? _mm512_loadu_ps(out + j + 48) : _mm512_setzero_ps();
+                for(std::size_t i = i0; i < i1; i++){
+                    const float *a = data + offsets[i] + block + j;
+                    const float *b = data + offsets[k-1-i] + block + j + i + 1;
+                    acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a), _mm512_loadu_ps(b), acc0);
+                    acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + 16), _mm512_loadu_ps(b + 16), acc1);
+                    acc2 = _mm512_fmadd_ps(_mm512_loadu_ps(a + 32), _mm512_loadu_ps(b + 32), acc2);
+                    acc3 = _mm512_fmadd_ps(_mm512_loadu_ps(a + 48), _mm512_loadu_ps(b + 48), acc3);
+                }
+                _mm512_storeu_ps(out + j, acc0);
+                _mm512_storeu_ps(out + j + 16, acc1);
+                _mm512_storeu_ps(out + j + 32, acc2);
+                _mm512_storeu_ps(out + j + 48, acc3);
+            }
+            // Masked tail, one vector at a time
+            for(; j < len; j += 16){
+                __mmask16 mask = static_cast<__mmask16>(len - j >= 16 ? 0xFFFF : (1u << (len - j)) - 1);
+                __m512 acc = i0 ? _mm512_maskz_loadu_ps(mask, out + j) : _mm512_setzero_ps();
+                for(std::size_t i = i0; i < i1; i++){
+                    const float *a = data + offsets[i] + block + j;
+                    const float *b = data + offsets[k-1-i] + block + j + i + 1;
+                    acc = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a), _mm512_maskz_loadu_ps(mask, b), acc);
+                }
+                _mm512_mask_storeu_ps(out + j, mask, acc);
+            }
+        }
+    }
+};
+
+/*!
+    \name DispatchDot
+    \brief Dot product picking SSE2, AVX, AVX2/FMA or AVX-512 at startup
+    \note The ISA comes from cpuid (__builtin_cpu_supports) on first use, the WAVEFRONT_ISA
+          environment variable (scalar, sse2, avx, avx2, avx512) can force a lower one
+*/
+struct DispatchDot{
+    static constexpr bool kBatchCbrt = false;
+
+    enum Isa { kScalar, kSse2, kAvx, kAvx2, kAvx512 };
+
+    static Isa Detect(){
+        __builtin_cpu_init();
+        Isa isa = kScalar;
+        if(__builtin_cpu_supports("sse2")) isa = kSse2;
+        if(__builtin_cpu_supports("avx")) isa = kAvx;
+        if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) isa = kAvx2;
+        if(__builtin_cpu_supports("avx512f")) isa = kAvx512;
+        // Never pick an ISA the CPU does not have
+        if(const char *forced = std::getenv("WAVEFRONT_ISA")){
+            std::string name(forced);
+            Isa wanted = name == "scalar" ? kScalar : name == "sse2" ? kSse2 : name == "avx" ? kAvx :
+                         name == "avx2" ? kAvx2 : kAvx512;
+            if(wanted < isa) isa = wanted;
+        }
+        return isa;
+    }
+
+    static Isa Selected(){
+        static const Isa isa = Detect();
+        return isa;
+    }
+
+    static const char *Name(){
+        static const char *names[] = {"scalar", "sse2", "avx", "avx2", "avx512"};
+        return names[Selected()];
+    }
+
+    template <typename T>
+    struct Table{
+        T (*compute)(const T*, const T*, std::size_t);
+        void (*sweep_diagonal)(T*, const T*, const std::size_t*, std::size_t, std::size_t, std::size_t);
+    };
+
+    template <typename Dot, typename T>
+    static Table<T> Make(){
+        return {[](const T *a, const T *b, std::size_t n){ return Dot::Compute(a, b, n); },
+                [](T *out, const T *data, const std::size_t *offsets, std::size_t k, std::size_t block, std::size_t len){
+                    Dot::SweepDiagonal(out, data, offsets, k, block, len);
+                }};
+    }
+
+    template <typename T>
+    static const Table<T> &Kernels(){
+        static const Table<T> table = [](){
+            switch(Selected()){
+                case kAvx512: return Make<Avx512Dot, T>();
+                case kAvx2: return Make<Avx2FmaDot, T>();
+                case kAvx: return Make<AvxDot, T>();
+                case kSse2: return Make<Sse2Dot, T>();
+                default: return Make<ScalarDot, T>();
+            }
+        }();
+        return table;
+    }
+
+    template <typename T>
+    static T Compute(const T *a, const T *b, std::size_t n){
+        return Kernels<T>().compute(a, b, n);
+    }
+
+    template <typename T>
+    static void SweepDiagonal(T *out, const T *data, const std::size_t *offsets, std::size_t k, std::size_t block, std::size_t len){
+        Kernels<T>().sweep_diagonal(out, data, offsets, k, block, len);
+    }
+};
+#endif
+
+// Fastest kernel available: the widest ISA the translation unit is compiled for, or the
+// runtime dispatch for portable x86 builds
+#if defined(__AVX512F__)
+using DefaultDot = Avx512Dot;
+#elif defined(__AVX2__) && defined(__FMA__)
+using DefaultDot = Avx2FmaDot;
+#elif defined(WAVEFRONT_X86)
+using DefaultDot = DispatchDot;
+#else
+using DefaultDot = ScalarDot;
+#endif
+
+} // namespace wavefront
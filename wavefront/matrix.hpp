@@ -0,0 +1,133 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <iomanip>
+#include <fstream>
+
+#include "pages.hpp"
+
+namespace wavefront{
+
+/*!
+    \name RowMajor
+    \brief Full N*N row-major matrix, only the upper triangle is computed
+    \note Layout of wavefront_seq and wavefront_pf - the column operand of the dot product has stride N
+*/
+template <typename T, typename Allocator = PageAllocator<T>>
+struct RowMajor{
+    using value_type = T;
+    static constexpr bool kUnitStride = false;
+    static constexpr bool kDiagonalMajor = false;
+
+    std::size_t N;
+    std::vector<T, Allocator> data;
+
+    explicit RowMajor(std::size_t N, const Allocator &allocator = Allocator()) : N(N), data(N*N, allocator) {}
+
+    T Get(std::size_t i, std::size_t j) const { return data[i*N+j]; }                // M[i][j]
+    const T *Row(std::size_t m) const { return &data[m*N+m]; }                        // Row(m)[i] = M[m][m+i]
+    const T *Column(std::size_t c) const { return &data[c]; }                         // Column(c)[r*N] = M[r][c]
+    std::size_t ColumnStride() const { return N; }
+    void Store(std::size_t m, std::size_t k, T value){ data[m*N+m+k] = value; }       // M[m][m+k]
+};
+
+/*!
+    \name RowMajorMirror
+    \brief Full N*N row-major matrix with the transposed upper triangle mirrored in the lower one
+    \note Layout of the *_cache variants - row m+k of the lower triangle holds column m+k, so both
+          operands of the dot product are contiguous
+*/
+template <typename T, typename Allocator = PageAllocator<T>>
+struct RowMajorMirror{
+    using value_type = T;
+    static constexpr bool kUnitStride = true;
+    static constexpr bool kDiagonalMajor = false;
+
+    std::size_t N;
+    std::vector<T, Allocator> data;
+
+    explicit RowMajorMirror(std::size_t N, const Allocator &allocator = Allocator()) : N(N), data(N*N, allocator) {}
+
+    T Get(std::size_t i, std::size_t j) const { return data[i*N+j]; }                // M[i][j]
+    const T *Row(std::size_t m) const { return &data[m*N+m]; }                        // Row(m)[i] = M[m][m+i]
+    const T *Column(std::size_t c) const { return &data[c*N]; }                       // Column(c)[r] = M[r][c]
+    std::size_t ColumnStride() const { return 1; }
+    void Store(std::size_t m, std::size_t k, T value){
+        data[m*N+m+k] = value;      // M[m][m+k]
+        data[(m+k)*N+m] = value;    // Update the element for the transpose matrix
+    }
+};
+
+/*!
+    \name PackedDiagonal
+    \brief Packed upper triangle stored diagonal by diagonal, about N*(N+1)/2 elements
+    \note Diagonal d holds M[m][m+d] for m in [0, N-d) contiguously and starts on a cache line, so
+          workers writing disjoint line-sized chunks of a diagonal never share a line. A single
+          element is not a contiguous dot product here, but a whole diagonal is: ComputeDiagonal
+          sweeps it as sum_i D_i[m] * D_{k-1-i}[m+1+i], unit stride in m for both operands
+*/
+template <typename T, typename Allocator = PageAllocator<T>>
+struct PackedDiagonal{
+    using value_type = T;
+    static constexpr bool kUnitStride = false;
+    static constexpr bool kDiagonalMajor = true;
+    static constexpr std::size_t kLine = kCacheLine/sizeof(T);     // Elements per cache line
+
+    std::size_t N;
+    std::vector<std::size_t> offsets;                               // offsets[d] = first element of the d-th diagonal
+    std::vector<T, Allocator> data;
+
+    explicit PackedDiagonal(std::size_t N, const Allocator &allocator = Allocator()) : N(N), offsets(N+1, 0), data(allocator) {
+        // Pad every diagonal to a whole number of cache lines
+        for(std::size_t d = 0; d < N; d++){
+            offsets[d+1] = offsets[d] + (N-d + kLine-1)/kLine*kLine;
+        }
+        data.resize(offsets[N]);
+    }
+
+    std::size_t Offset(std::size_t d) const { return offsets[d]; }
+
+    T Get(std::size_t i, std::size_t j) const { return j < i ? T(0) : data[Offset(j-i)+i]; }    // M[i][j]
+    T *Diagonal(std::size_t d){ return &data[Offset(d)]; }                                        // Diagonal(d)[m] = M[m][m+d]
+    const T *Diagonal(std::size_t d) const { return &data[Offset(d)]; }
+    void Store(std::size_t m, std::size_t k, T value){ data[Offset(k)+m] = value; }              // M[m][m+k]
+};
+
+/*!
+    \name FillMatrix
+    \param M matrix layout
+    \brief Fill the matrix M with the values
+    \note Fill the diagonal elements (i,j) (where i == j) with (m+1)/N
+*/
+template <typename Layout>
+void FillMatrix(Layout &M){
+    using T = typename Layout::value_type;
+    for(std::size_t m = 0; m < M.N; m++){
+        M.Store(m, 0, static_cast<T>(m+1)/M.N); // M[m][m] = (m+1)/N
+    }
+}
+
+/*!
+    \name SaveMatrixToFile
+    \param M matrix layout
+    \param filename string filename
+    \brief Save the matrix M to a file
+    \note Save the matrix M to a file with the name filename
+*/
+template <typename Layout>
+void SaveMatrixToFile(const Layout &M, std::string filename){
+    std::ofstream file;
+    file.open(filename);
+    file << std::fixed << std::setprecision(6);
+    for(std::size_t i = 0; i < M.N; i++){
+        for(std::size_t j = 0; j < M.N; j++){
+            file << M.Get(i, j) << " ";  // M[i][j]
+        }
+        file << std::endl;
+    }
+    file.close();
+}
+
+} // namespace wavefront
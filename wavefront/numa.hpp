@@ -0,0 +1,86 @@
+#pragma once
+
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+
+#include <sched.h>
+#include <pthread.h>
+
+#include "pages.hpp"
+#include "matrix.hpp"
+
+namespace wavefront{
+
+/*!
+    \name PinThread
+    \param index thread index
+    \brief Pin the calling thread to the index-th CPU the process may run on (round robin)
+*/
+inline void PinThread(std::size_t index){
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if(sched_getaffinity(0, sizeof(allowed), &allowed) != 0 || CPU_COUNT(&allowed) == 0){
+        return;
+    }
+    std::size_t target = index % CPU_COUNT(&allowed);
+    for(int cpu = 0; cpu < CPU_SETSIZE; cpu++){
+        if(CPU_ISSET(cpu, &allowed) && target-- == 0){
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+            return;
+        }
+    }
+}
+
+/*!
+    \name TouchPartition
+    \brief Zero the part of the matrix worker id of W writes: a block of rows for the row-major
+           layouts, a block of every diagonal for PackedDiagonal (the partitions of ComputeDiagonal)
+*/
+template <typename Layout>
+void TouchPartition(Layout &M, std::size_t id, std::size_t W){
+    using T = typename Layout::value_type;
+    const std::size_t N = M.N;
+    if constexpr (Layout::kDiagonalMajor){
+        for(std::size_t d = 0; d < N; d++){
+            std::size_t begin = (N-d)*id/W, end = (N-d)*(id+1)/W;
+            std::memset(M.Diagonal(d) + begin, 0, (end - begin)*sizeof(T));
+        }
+    } else {
+        std::size_t begin = N*id/W, end = N*(id+1)/W;
+        std::memset(M.data.data() + begin*N, 0, (end - begin)*N*sizeof(T));
+    }
+}
+
+/*!
+    \name FirstTouch
+    \param M matrix built on PageAllocator, not yet filled
+    \param W number of workers
+    \param pin pin the i-th toucher like the i-th worker (PinThread(i))
+    \brief Place the pages of each worker's partition on that worker's node
+    \note Call before FillMatrix. Only meaningful with pin, an unpinned toucher places its pages
+          wherever the scheduler runs it. For the row-major layouts the row blocks match the
+          workers' slices of the early diagonals only, PackedDiagonal matches on every diagonal
+*/
+template <typename Layout>
+void FirstTouch(Layout &M, std::size_t W, bool pin){
+    std::vector<std::thread> threads;
+    for(std::size_t id = 0; id < W; id++){
+        threads.emplace_back([&M, id, W, pin]{
+            if(pin){
+                PinThread(id);
+            }
+            TouchPartition(M, id, W);
+        });
+    }
+    for(auto &thread : threads){
+        thread.join();
+    }
+}
+
+} // namespace wavefront
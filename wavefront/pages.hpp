@@ -0,0 +1,177 @@
+#pragma once
+
+#include <new>
+#include <string>
+#include <cstddef>
+#include <cstdlib>
+#include <utility>
+
+#include <sys/mman.h>
+#if defined(WAVEFRONT_NUMA)
+    #include <numa.h>
+#endif
+
+namespace wavefront{
+
+// Size of a cache line in bytes
+constexpr std::size_t kCacheLine = 64;
+
+/*!
+    \name HugePages
+    \brief Page size backing the matrix
+    \note kOff:        4K pages
+          kTransparent: 4K mapping with madvise(MADV_HUGEPAGE), the kernel promotes it to 2M pages
+          k2M, k1G:     explicit hugetlbfs pages (MAP_HUGETLB), they must be reserved in
+                        /proc/sys/vm/nr_hugepages or /sys/kernel/mm/hugepages
+          Every explicit size falls back to the next smaller one, down to kTransparent, when the
+          pages are not available
+*/
+enum class HugePages {kOff, kTransparent, k2M, k1G};
+
+/*!
+    \name NumaPolicy
+    \brief Page placement of the matrix
+    \note kNone:       pages are placed by whoever touches them first (main thread fills the diagonal)
+          kFirstTouch: FirstTouch zeroes each worker's partition from that worker's core
+          kInterleave: pages are spread round robin over all nodes (needs WAVEFRONT_NUMA and libnuma,
+                       see NumaAvailable, otherwise it behaves as kNone)
+*/
+enum class NumaPolicy {kNone, kFirstTouch, kInterleave};
+
+/*!
+    \name NumaAvailable
+    \brief Whether kInterleave has any effect: a WAVEFRONT_NUMA build on a kernel with NUMA support
+*/
+inline bool NumaAvailable(){
+#if defined(WAVEFRONT_NUMA)
+    return numa_available() >= 0;
+#else
+    return false;
+#endif
+}
+
+/*!
+    \name DefaultHugePages
+    \brief Huge page setting of every matrix, read once from WAVEFRONT_HUGEPAGES=off|thp|2M|1G
+    \note Off when the variable is unset or unknown
+*/
+inline HugePages DefaultHugePages(){
+    static const HugePages huge = []{
+        const char *env = std::getenv("WAVEFRONT_HUGEPAGES");
+        std::string value = env ? env : "";
+        if(value == "thp"){
+            return HugePages::kTransparent;
+        } else if(value == "2M"){
+            return HugePages::k2M;
+        } else if(value == "1G"){
+            return HugePages::k1G;
+        }
+        return HugePages::kOff;
+    }();
+    return huge;
+}
+
+/*!
+    \name MapPages
+    \param bytes size of the mapping
+    \param huge requested page size
+    \param length set to the size actually mapped
+    \brief Anonymous, zero-filled mapping backed by the largest available page size up to huge
+    \note An explicit huge page is only used when the mapping fills at least one, so small
+          allocations (the panels of DistributedPanels) do not each reserve a whole 1G or 2M page
+    \return the mapping, nullptr on failure
+*/
+inline void *MapPages(std::size_t bytes, HugePages huge, std::size_t &length){
+    const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    void *p = MAP_FAILED;
+    if(huge == HugePages::k1G && bytes < (1UL << 30)){
+        huge = HugePages::k2M;
+    }
+    if(huge == HugePages::k2M && bytes < (1UL << 21)){
+        huge = HugePages::kTransparent;
+    }
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_1GB) && defined(MAP_HUGE_2MB)
+    if(huge == HugePages::k1G){
+        length = (bytes + (1UL << 30)-1) & ~((1UL << 30)-1);
+        p = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB | MAP_HUGE_1GB, -1, 0);
+        huge = HugePages::k2M;
+    }
+    if(p == MAP_FAILED && huge == HugePages::k2M){
+        length = (bytes + (1UL << 21)-1) & ~((1UL << 21)-1);
+        p = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB | MAP_HUGE_2MB, -1, 0);
+        huge = HugePages::kTransparent;
+    }
+#else
+    if(huge != HugePages::kOff){
+        huge = HugePages::kTransparent;
+    }
+#endif
+    if(p == MAP_FAILED){
+        length = bytes;
+        p = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if(p == MAP_FAILED){
+            return nullptr;
+        }
+    #if defined(MADV_HUGEPAGE)
+        if(huge != HugePages::kOff){
+            madvise(p, length, MADV_HUGEPAGE);
+        }
+    #endif
+    }
+    return p;
+}
+
+/*!
+    \name PageAllocator
+    \brief Allocator mapping whole pages for the matrix, optionally huge and/or interleaved
+    \note The mapped length is kept in a cache line in front of the data, the data itself is
+          cache-line aligned. Default allocator of the layouts, so WAVEFRONT_HUGEPAGES applies to
+          every variant. The kernel hands out zero-filled pages, so elements are default-initialised
+          instead of zeroed: building a layout writes nothing and places no page, only FillMatrix
+          (the diagonal), FirstTouch and the computation do
+*/
+template <typename T>
+struct PageAllocator{
+    using value_type = T;
+
+    HugePages huge = DefaultHugePages();
+    NumaPolicy numa = NumaPolicy::kNone;
+
+    PageAllocator() = default;
+    explicit PageAllocator(NumaPolicy numa) : numa(numa) {}
+    PageAllocator(HugePages huge, NumaPolicy numa) : huge(huge), numa(numa) {}
+    template <typename U>
+    PageAllocator(const PageAllocator<U> &other) : huge(other.huge), numa(other.numa) {}
+
+    T *allocate(std::size_t n){
+        std::size_t length;
+        char *p = static_cast<char*>(MapPages(kCacheLine + n*sizeof(T), huge, length));
+        if(p == nullptr){
+            throw std::bad_alloc();
+        }
+    #if defined(WAVEFRONT_NUMA)
+        if(numa == NumaPolicy::kInterleave && numa_available() >= 0){
+            numa_interleave_memory(p, length, numa_all_nodes_ptr);
+        }
+    #endif
+        *reinterpret_cast<std::size_t*>(p) = length;
+        return reinterpret_cast<T*>(p + kCacheLine);
+    }
+    void deallocate(T *data, std::size_t){
+        char *p = reinterpret_cast<char*>(data) - kCacheLine;
+        munmap(p, *reinterpret_cast<std::size_t*>(p));
+    }
+
+    // Default-initialise instead of value-initialise: no write, no page fault
+    template <typename U>
+    void construct(U *p){ ::new(static_cast<void*>(p)) U; }
+    template <typename U, typename... Args>
+    void construct(U *p, Args&&... args){ ::new(static_cast<void*>(p)) U(std::forward<Args>(args)...); }
+
+    template <typename U>
+    bool operator==(const PageAllocator<U> &other) const { return huge == other.huge && numa == other.numa; }
+    template <typename U>
+    bool operator!=(const PageAllocator<U> &other) const { return !(*this == other); }
+};
+
+} // namespace wavefront
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+#include "pages.hpp"
+#include "tiles.hpp"
+#include "kernels.hpp"
+
+namespace wavefront{
+
+/*!
+    \name TileGrid
+    \brief 2D block-cyclic distribution of the B x B tiles over a Pr x Pc process grid
+    \note Tile (I, J) belongs to the process (I mod Pr, J mod Pc). Tile (I, J) reads the tiles of
+          its tile row on its left and of its tile column below it, so a process only ever needs
+          its tile rows (from the processes of its grid row) and its tile columns (from the
+          processes of its grid column)
+*/
+struct TileGrid{
+    std::size_t N;
+    std::size_t B;
+    std::size_t tiles;                  // Tiles per side
+    std::size_t Pr;
+    std::size_t Pc;
+
+    TileGrid(std::size_t N, std::size_t B, std::size_t Pr, std::size_t Pc)
+        : N(N), B(B), tiles((N + B-1)/B), Pr(Pr), Pc(Pc) {}
+
+    /*!
+        \name ForOwned
+        \param d tile diagonal, J - I
+        \param pr, pc grid position
+        \param f f(tile) for each tile of the d-th tile diagonal owned by (pr, pc), in increasing I
+    */
+    template <typename F>
+    void ForOwned(std::size_t d, std::size_t pr, std::size_t pc, F f) const {
+        for(std::size_t I = pr; I + d < tiles; I += Pr){
+            if((I + d) % Pc == pc){
+                f(Tile{I, I + d});
+            }
+        }
+    }
+
+    // Number of tiles of the d-th tile diagonal owned by (pr, pc)
+    std::size_t CountOwned(std::size_t d, std::size_t pr, std::size_t pc) const {
+        std::size_t count = 0;
+        ForOwned(d, pr, pc, [&](Tile){ count++; });
+        return count;
+    }
+};
+
+/*!
+    \name DistributedPanels
+    \brief The part of the upper triangle one process of a TileGrid stores
+    \note Row panel of tile row I:    rows [I*B, (I+1)*B), columns [I*B, N), row-major
+          Column panel of tile col J: columns [J*B, (J+1)*B), rows [0, (J+1)*B), column-major
+          Both operands of every dot product of an owned tile are contiguous: the row in the row
+          panel and the column in the column panel. About N*N/2 * (1/Pr + 1/Pc) elements
+*/
+template <typename T>
+struct DistributedPanels{
+    using Panel = std::vector<T, PageAllocator<T>>;
+
+    TileGrid grid;
+    std::size_t pr;
+    std::size_t pc;
+    std::vector<Panel> rows;            // rows[i] = panel of tile row pr + i*Pr
+    std::vector<Panel> columns;         // columns[j] = panel of tile column pc + j*Pc
+
+    DistributedPanels(const TileGrid &grid, std::size_t pr, std::size_t pc) : grid(grid), pr(pr), pc(pc) {
+        for(std::size_t I = pr; I < grid.tiles; I += grid.Pr){
+            rows.emplace_back(RowHeight(I)*RowWidth(I));
+        }
+        for(std::size_t J = pc; J < grid.tiles; J += grid.Pc){
+            columns.emplace_back(ColumnWidth(J)*ColumnHeight(J));
+        }
+    }
+
+    std::size_t RowHeight(std::size_t I) const { return std::min(grid.B, grid.N - I*grid.B); }
+    std::size_t RowWidth(std::size_t I) const { return grid.N - I*grid.B; }
+    std::size_t ColumnWidth(std::size_t J) const { return std::min(grid.B, grid.N - J*grid.B); }
+    std::size_t ColumnHeight(std::size_t J) const { return std::min(grid.N, (J+1)*grid.B); }
+
+    // M[m][c] in the row panel, m in an owned tile row
+    T &Row(std::size_t m, std::size_t c){
+        std::size_t I = m/grid.B;
+        return rows[I/grid.Pr][(m - I*grid.B)*RowWidth(I) + (c - I*grid.B)];
+    }
+    // M[r][c] in the column panel, c in an owned tile column
+    T &Column(std::size_t r, std::size_t c){
+        std::size_t J = c/grid.B;
+        return columns[J/grid.Pc][(c - J*grid.B)*ColumnHeight(J) + r];
+    }
+
+    // Fill the diagonal elements of the panels with (m+1)/N
+    void Fill(){
+        for(std::size_t I = pr; I < grid.tiles; I += grid.Pr){
+            for(std::size_t m = I*grid.B; m < I*grid.B + RowHeight(I); m++){
+                Row(m, m) = static_cast<T>(m+1)/grid.N;
+            }
+        }
+        for(std::size_t J = pc; J < grid.tiles; J += grid.Pc){
+            for(std::size_t c = J*grid.B; c < J*grid.B + ColumnWidth(J); c++){
+                Column(c, c) = static_cast<T>(c+1)/grid.N;
+            }
+        }
+    }
+
+    /*!
+        \name ComputeTile
+        \brief Compute an owned tile into both its row and its column panel
+    */
+    template <typename Dot>
+    void ComputeTile(Tile tile){
+        ForEachTileDiagonal(grid.N, grid.B, tile, [&](std::size_t k, std::size_t m_begin, std::size_t m_end){
+            for(std::size_t m = m_begin; m < m_end; m++){
+                const std::size_t c = m+k;
+                T value = std::cbrt(Dot::Compute(&Row(m, m), &Column(m+1, c), k));
+                Row(m, c) = value;
+                Column(m, c) = value;
+            }
+        });
+    }
+
+    // Size of a packed tile
+    std::size_t TileSize() const { return grid.B*grid.B; }
+
+    // Copy the upper-triangle elements of an owned tile from its row panel, B x B row-major
+    void Pack(Tile tile, T *out){
+        ForTileElements(tile, [&](std::size_t m, std::size_t c, std::size_t offset){ out[offset] = Row(m, c); });
+    }
+    // Store a packed tile of an owned tile row into the row panel
+    void UnpackRow(Tile tile, const T *in){
+        ForTileElements(tile, [&](std::size_t m, std::size_t c, std::size_t offset){ Row(m, c) = in[offset]; });
+    }
+    // Store a packed tile of an owned tile column into the column panel
+    void UnpackColumn(Tile tile, const T *in){
+        ForTileElements(tile, [&](std::size_t m, std::size_t c, std::size_t offset){ Column(m, c) = in[offset]; });
+    }
+
+private:
+    template <typename F>
+    void ForTileElements(Tile tile, F f){
+        const std::size_t row_begin = tile.I*grid.B, row_end = std::min(grid.N, row_begin + grid.B);
+        const std::size_t col_begin = tile.J*grid.B, col_end = std::min(grid.N, col_begin + grid.B);
+        for(std::size_t m = row_begin; m < row_end; m++){
+            for(std::size_t c = std::max(m, col_begin); c < col_end; c++){
+                f(m, c, (m - row_begin)*grid.B + (c - col_begin));
+            }
+        }
+    }
+};
+
+} // namespace wavefront
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdlib>
+#include <algorithm>
+
+namespace wavefront{
+
+// Multiply-adds a chunk should carry at least to amortise its scheduling (adaptive policy)
+constexpr std::size_t kMinChunkWork = 8192;
+// Chunks per worker on a diagonal, for load balancing (adaptive policy)
+constexpr std::size_t kChunksPerWorker = 4;
+
+/*!
+    \name Schedule
+    \brief Scheduling policy of the ParallelFor drivers, one parallel_for per diagonal
+    \note kDefault:  FastFlow defaults, parallel_for(0, N-k, body)
+          kStatic:   static scheduling, one block per worker (grain 0) or round robin chunks of grain
+          kDynamic:  dynamic scheduling, chunks of grain (default 1)
+          kAdaptive: chunk size and number of workers picked per diagonal by AdaptiveChunk
+          The loops run on ff::ParallelFor (kFastFlow) or on wavefront::StealingPool (kStealing),
+          where the grain is the size below which a range is no longer split
+*/
+struct Schedule{
+    enum Policy {kDefault, kStatic, kDynamic, kAdaptive};
+    enum Backend {kFastFlow, kStealing};
+
+    Policy policy = kDefault;
+    Backend backend = kFastFlow;
+    long grain = 0;
+    bool spinwait = false;      // Workers spin between two parallel_for instead of sleeping (non-blocking)
+    bool spinbarrier = false;   // Spinning barrier at the end of each parallel_for
+};
+
+/*!
+    \name ParseSchedule
+    \param argc, argv command line
+    \param first index of the first option in argv
+    \param schedule filled with the options
+    \brief Parse --schedule=default|static|dynamic|adaptive, --backend=fastflow|steal, --grain=G,
+           --spinwait and --spinbarrier
+    \return false on an unknown option
+*/
+inline bool ParseSchedule(int argc, char* argv[], int first, Schedule &schedule){
+    for(int i = first; i < argc; i++){
+        std::string option = argv[i];
+        if(option == "--schedule=default"){
+            schedule.policy = Schedule::kDefault;
+        } else if(option == "--schedule=static"){
+            schedule.policy = Schedule::kStatic;
+        } else if(option == "--schedule=dynamic"){
+            schedule.policy = Schedule::kDynamic;
+        } else if(option == "--schedule=adaptive"){
+            schedule.policy = Schedule::kAdaptive;
+        } else if(option == "--backend=fastflow"){
+            schedule.backend = Schedule::kFastFlow;
+        } else if(option == "--backend=steal"){
+            schedule.backend = Schedule::kStealing;
+        } else if(option.rfind("--grain=", 0) == 0){
+            schedule.grain = std::strtol(option.c_str() + 8, nullptr, 10);
+            if(schedule.grain < 0){
+                return false;
+            }
+        } else if(option == "--spinwait"){
+            schedule.spinwait = true;
+        } else if(option == "--spinbarrier"){
+            schedule.spinbarrier = true;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+    \name AdaptiveChunk
+    \param length number of elements on the diagonal (N-k)
+    \param k diagonal index, the work of an element
+    \param workers number of workers
+    \brief Chunk size for the k-th diagonal
+    \note kChunksPerWorker chunks per worker for balance, but never less than kMinChunkWork
+          multiply-adds per chunk: on the late diagonals a chunk gets few, long elements, on the
+          early ones many short ones
+*/
+inline std::size_t AdaptiveChunk(std::size_t length, std::size_t k, std::size_t workers){
+    std::size_t balanced = (length + kChunksPerWorker*workers - 1)/(kChunksPerWorker*workers);
+    std::size_t amortised = (kMinChunkWork + k-1)/k;
+    return std::min(length, std::max({balanced, amortised, std::size_t(1)}));
+}
+
+/*!
+    \name ParallelDiagonal
+    \param pf ff::ParallelFor or wavefront::StealingPool
+    \param schedule scheduling policy
+    \param length number of elements on the diagonal (N-k)
+    \param k diagonal index
+    \param workers number of workers of pf
+    \param body body(m) computes the m-element of the diagonal
+    \brief Run body over [0, length) with the given policy
+    \note With kAdaptive only as many workers as chunks take part, and a diagonal that fits in one
+          chunk runs on the calling thread without going through the scheduler
+*/
+template <typename ParallelFor, typename Body>
+void ParallelDiagonal(ParallelFor &pf, const Schedule &schedule, std::size_t length, std::size_t k, std::size_t workers, const Body &body){
+    switch(schedule.policy){
+        case Schedule::kStatic:
+            // FastFlow: grain 0 is static block scheduling, a negative grain static round robin chunks
+            pf.parallel_for(0, length, 1, -schedule.grain, body);
+            break;
+        case Schedule::kDynamic:
+            pf.parallel_for(0, length, 1, std::max(schedule.grain, 1L), body);
+            break;
+        case Schedule::kAdaptive: {
+            std::size_t chunk = AdaptiveChunk(length, k, workers);
+            std::size_t active = std::min(workers, (length + chunk-1)/chunk);
+            if(active <= 1){
+                for(std::size_t m = 0; m < length; m++){
+                    body(m);
+                }
+            } else {
+                pf.parallel_for(0, length, 1, chunk, body, active);
+            }
+            break;
+        }
+        default:
+            pf.parallel_for(0, length, body);
+            break;
+    }
+}
+
+} // namespace wavefront
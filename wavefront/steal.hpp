@@ -0,0 +1,230 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <condition_variable>
+
+#include "matrix.hpp"
+
+namespace wavefront{
+
+/*!
+    \name StealingPool
+    \brief Work-stealing thread pool with the parallel_for interface of ff::ParallelFor
+    \note Each thread owns a deque of index ranges. A loop is first cut into one range per thread,
+          a thread then splits the range it runs in halves down to the grain, keeping the lower
+          half and pushing the upper one on its deque. An idle thread steals the oldest (largest)
+          range of a random victim. The calling thread is worker 0, the other W-1 threads persist
+          between loops and sleep on a condition variable after a short spin
+*/
+class StealingPool{
+public:
+    explicit StealingPool(long workers) : nw(std::max(workers, 1L)), deques(nw) {
+        for(long id = 1; id < nw; id++){
+            threads.emplace_back([this, id]{ Worker(id); });
+        }
+    }
+
+    ~StealingPool(){
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+            epoch++;
+        }
+        wakeup.notify_all();
+        for(auto &thread : threads){
+            thread.join();
+        }
+    }
+
+    StealingPool(const StealingPool&) = delete;
+    StealingPool &operator=(const StealingPool&) = delete;
+
+    /*!
+        \name parallel_for_idx
+        \param first, last range of the loop
+        \param step stride of the loop
+        \param grain ranges up to grain iterations are not split further, <= 0 picks
+               kChunksPerThread ranges per thread
+        \param body body(begin, end, thread_id)
+        \param n threads the loop is first cut for (all of them by default)
+    */
+    template <typename Body>
+    void parallel_for_idx(long first, long last, long step, long grain, const Body &body, long n = -1){
+        if(first >= last){
+            return;
+        }
+        const long iterations = (last - first + step-1)/step;
+        const long parts = n > 0 ? std::min(n, nw) : nw;
+        if(grain <= 0){
+            grain = std::max(1L, (iterations + kChunksPerThread*nw - 1)/(kChunksPerThread*nw));
+        }
+        job = Job{first, step, grain, &body, &Invoke<Body>};
+        pending.store(iterations, std::memory_order_relaxed);
+        // Seed one contiguous range per thread
+        for(long t = 0; t < parts; t++){
+            long begin = iterations*t/parts, end = iterations*(t+1)/parts;
+            if(begin < end){
+                deques[t].Push({begin, end});
+            }
+        }
+        finished.store(0, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            epoch.fetch_add(1, std::memory_order_release);
+        }
+        wakeup.notify_all();
+        Run(0);
+        // Every thread leaves the loop before the job can be overwritten
+        while(finished.load(std::memory_order_acquire) < nw-1){
+            std::this_thread::yield();
+        }
+    }
+
+    template <typename Body>
+    void parallel_for(long first, long last, long step, long grain, const Body &body, long n = -1){
+        parallel_for_idx(first, last, step, grain, [&](const long begin, const long end, const int){
+            for(long i = begin; i < end; i += step){
+                body(i);
+            }
+        }, n);
+    }
+
+    template <typename Body>
+    void parallel_for(long first, long last, const Body &body, long n = -1){
+        parallel_for(first, last, 1, 0, body, n);
+    }
+
+    long Workers() const { return nw; }
+
+private:
+    static constexpr long kChunksPerThread = 4;
+    static constexpr int kSpin = 1 << 12;      // Polls of the epoch before sleeping
+
+    // Range of iteration numbers [begin, end)
+    struct Range{
+        long begin;
+        long end;
+    };
+
+    // Deque of ranges under a spinlock, the owner works at the back, the thieves at the front.
+    // Every pushed range is smaller than the ones before it, so it never holds more than ~64
+    struct alignas(kCacheLine) Deque{
+        static constexpr std::size_t kCapacity = 128;
+        std::atomic_flag lock = ATOMIC_FLAG_INIT;
+        std::size_t head = 0;
+        std::size_t tail = 0;
+        Range ranges[kCapacity];
+
+        void Lock(){ while(lock.test_and_set(std::memory_order_acquire)) {} }
+        void Unlock(){ lock.clear(std::memory_order_release); }
+
+        void Push(Range range){
+            Lock();
+            ranges[tail++ % kCapacity] = range;
+            Unlock();
+        }
+        bool PopBack(Range &range){
+            Lock();
+            bool found = head != tail;
+            if(found){
+                range = ranges[--tail % kCapacity];
+            }
+            Unlock();
+            return found;
+        }
+        bool PopFront(Range &range){
+            Lock();
+            bool found = head != tail;
+            if(found){
+                range = ranges[head++ % kCapacity];
+            }
+            Unlock();
+            return found;
+        }
+    };
+
+    // Type-erased loop body
+    struct Job{
+        long first;
+        long step;
+        long grain;
+        const void *body;
+        void (*invoke)(const void*, long, long, int);
+    };
+
+    template <typename Body>
+    static void Invoke(const void *body, long begin, long end, int id){
+        (*static_cast<const Body*>(body))(begin, end, id);
+    }
+
+    // Take ranges from the own deque, then from the others, until the loop is done
+    void Run(long id){
+        uint64_t seed = 0x9E3779B97F4A7C15ULL*(id+1);
+        while(pending.load(std::memory_order_acquire) > 0){
+            Range range;
+            if(deques[id].PopBack(range) || Steal(id, seed, range)){
+                // Split down to the grain, the upper halves are left to the thieves
+                while(range.end - range.begin > job.grain){
+                    long middle = range.begin + (range.end - range.begin)/2;
+                    deques[id].Push({middle, range.end});
+                    range.end = middle;
+                }
+                job.invoke(job.body, job.first + range.begin*job.step, job.first + range.end*job.step, id);
+                pending.fetch_sub(range.end - range.begin, std::memory_order_acq_rel);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // Victims are visited from a random one onwards
+    bool Steal(long id, uint64_t &seed, Range &range){
+        seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+        for(long i = 0; i < nw; i++){
+            long victim = (seed + i) % nw;
+            if(victim != id && deques[victim].PopFront(range)){
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Worker(long id){
+        uint64_t seen = 0;
+        for(;;){
+            // Spin a little for the next loop, then sleep
+            for(int i = 0; i < kSpin && epoch.load(std::memory_order_acquire) == seen; i++){
+                std::this_thread::yield();
+            }
+            if(epoch.load(std::memory_order_acquire) == seen){
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeup.wait(lock, [&]{ return epoch.load(std::memory_order_acquire) != seen; });
+            }
+            seen = epoch.load(std::memory_order_acquire);
+            if(stop){
+                return;
+            }
+            Run(id);
+            finished.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    long nw;
+    std::vector<Deque> deques;
+    std::vector<std::thread> threads;
+    Job job{};
+    std::atomic<long> pending{0};           // Iterations of the current loop not yet run
+    std::atomic<long> finished{0};          // Threads done with the current loop
+    std::atomic<uint64_t> epoch{0};         // Number of loops started
+    bool stop = false;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+};
+
+} // namespace wavefront
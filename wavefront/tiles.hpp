@@ -0,0 +1,115 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+#include "wavefront.hpp"
+
+namespace wavefront{
+
+/*!
+    \name Tile
+    \brief B x B tile (I, J), I <= J, of the upper triangle: rows [I*B, (I+1)*B), columns [J*B, (J+1)*B)
+*/
+struct Tile{
+    std::size_t I;
+    std::size_t J;
+};
+
+/*!
+    \name ForEachTileDiagonal
+    \param N matrix size
+    \param B tile size
+    \param tile the tile to visit
+    \param f f(k, m_begin, m_end) for each piece [m_begin, m_end) of the k-th diagonal in the tile
+    \brief Visit the elements of a tile diagonal by diagonal
+    \note (m, c) only reads elements of its row on its left and of its column below it, which have
+          a smaller c-m, either in this tile or in the tiles on its left and below
+*/
+template <typename F>
+void ForEachTileDiagonal(std::size_t N, std::size_t B, Tile tile, F f){
+    const std::size_t row_begin = tile.I*B;
+    const std::size_t row_end = std::min(N, row_begin + B);
+    const std::size_t col_begin = tile.J*B;
+    const std::size_t col_end = std::min(N, col_begin + B);
+    // k = c - m ranges from the bottom-left to the top-right corner of the tile
+    std::size_t k_begin = col_begin > row_end-1 ? col_begin - (row_end-1) : 1;
+    std::size_t k_end = col_end-1 - row_begin;
+    for(std::size_t k = std::max<std::size_t>(k_begin, 1); k <= k_end; k++){
+        // Rows of the tile whose column m+k also falls in the tile
+        std::size_t m_begin = std::max(row_begin, col_begin > k ? col_begin - k : 0);
+        std::size_t m_end = std::min(row_end, col_end - k);
+        if(m_begin < m_end){
+            f(k, m_begin, m_end);
+        }
+    }
+}
+
+/*!
+    \name ComputeTile
+    \param M matrix layout
+    \param B tile size
+    \param tile the tile to compute
+    \brief Compute every element of the tile
+*/
+template <typename Dot, typename Layout>
+void ComputeTile(Layout &M, std::size_t B, Tile tile){
+    ForEachTileDiagonal(M.N, B, tile, [&](std::size_t k, std::size_t m_begin, std::size_t m_end){
+        ComputeDiagonal<Dot>(M, k, m_begin, m_end);
+    });
+}
+
+/*!
+    \name TileGraph
+    \brief Dependency DAG of the tiles of the upper triangle
+    \note Tile (I, J) waits for its left (I, J-1) and below (I+1, J) neighbours, the tiles on the main
+          diagonal are ready from the start. Not thread safe, meant to be driven by one scheduler
+*/
+struct TileGraph{
+    std::size_t tiles_per_side;
+    std::vector<uint8_t> pending;       // Unfinished dependencies of each tile
+
+    TileGraph(std::size_t N, std::size_t B) : tiles_per_side((N + B-1)/B) {
+        pending.resize(Count());
+        for(std::size_t I = 0; I < tiles_per_side; I++){
+            for(std::size_t J = I; J < tiles_per_side; J++){
+                pending[Index({I, J})] = I == J ? 0 : 2;
+            }
+        }
+    }
+
+    // Number of tiles in the upper triangle
+    std::size_t Count() const { return tiles_per_side*(tiles_per_side+1)/2; }
+
+    // Row-major packed index of the tile
+    std::size_t Index(Tile tile) const { return tile.I*(2*tiles_per_side - tile.I + 1)/2 + (tile.J - tile.I); }
+
+    // Tiles without dependencies
+    std::vector<Tile> Roots() const {
+        std::vector<Tile> roots;
+        for(std::size_t I = 0; I < tiles_per_side; I++){
+            roots.push_back({I, I});
+        }
+        return roots;
+    }
+
+    /*!
+        \name Complete
+        \param tile finished tile
+        \param ready filled with the tiles that became ready
+        \brief Release the right and above neighbours of a finished tile
+    */
+    template <typename Out>
+    void Complete(Tile tile, Out &ready){
+        if(tile.J+1 < tiles_per_side && --pending[Index({tile.I, tile.J+1})] == 0){
+            ready.push_back(Tile{tile.I, tile.J+1});
+        }
+        if(tile.I > 0 && --pending[Index({tile.I-1, tile.J})] == 0){
+            ready.push_back(Tile{tile.I-1, tile.J});
+        }
+    }
+};
+
+} // namespace wavefront
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+
+#include "cbrt.hpp"
+#include "matrix.hpp"
+#include "kernels.hpp"
+
+namespace wavefront{
+
+// Elements of a diagonal-major diagonal swept together by ComputeDiagonal
+constexpr std::size_t kSweepBlock = 512;
+
+/*!
+    \name DotProduct
+    \param M matrix layout
+    \param m element index on the diagonal
+    \param k diagonal index
+    \brief Dot product of the m-element of the k-th diagonal
+    \note sum_i M[m][m+i] * M[m+i+1][m+k] for i in [0, k)
+*/
+template <typename Dot, typename Layout>
+inline typename Layout::value_type DotProduct(const Layout &M, std::size_t m, std::size_t k){
+    if constexpr (Layout::kDiagonalMajor){
+        // A single element reads one value from each of the diagonals [0, k)
+        typename Layout::value_type sum = 0;
+        for(std::size_t i = 0; i < k; i++){
+            sum += M.Get(m, m+i) * M.Get(m+i+1, m+k);
+        }
+        return sum;
+    } else {
+        const auto *row = M.Row(m);
+        const auto *col_t = M.Column(m+k) + (m+1)*M.ColumnStride();
+        if constexpr (Layout::kUnitStride){
+            return Dot::Compute(row, col_t, k);
+        } else {
+            return ScalarDot::Compute(row, col_t, k, M.ColumnStride());
+        }
+    }
+}
+
+/*!
+    \name ComputeElement
+    \brief Compute the m-element of the k-th diagonal without storing it
+    \note Cubic root of the dot product
+*/
+template <typename Dot, typename Layout>
+inline typename Layout::value_type ComputeElement(const Layout &M, std::size_t m, std::size_t k){
+    return std::cbrt(DotProduct<Dot>(M, m, k));
+}
+
+/*!
+    \name ComputeDiagonal
+    \param M matrix layout
+    \param k diagonal index
+    \param m_begin first element of the range
+    \param m_end one past the last element of the range
+    \brief Compute and store the elements [m_begin, m_end) of the k-th diagonal
+*/
+template <typename Dot, typename Layout>
+inline void ComputeDiagonal(Layout &M, std::size_t k, std::size_t m_begin, std::size_t m_end){
+    using T = typename Layout::value_type;
+    if constexpr (Layout::kDiagonalMajor){
+        // Sweep the range block by block, accumulating straight into the k-th diagonal
+        // (never read by its own dot products): sum_i M[m][m+i] * M[m+i+1][m+k]
+        for(std::size_t block = m_begin; block < m_end; block += kSweepBlock){
+            std::size_t len = std::min(kSweepBlock, m_end - block);
+            T *out = M.Diagonal(k) + block;
+            Dot::SweepDiagonal(out, M.data.data(), M.offsets.data(), k, block, len);
+            if constexpr (Dot::kBatchCbrt){
+                CbrtBatch(out, len);
+            } else {
+                for(std::size_t j = 0; j < len; j++){
+                    out[j] = std::cbrt(out[j]);
+                }
+            }
+        }
+    } else if constexpr (Dot::kBatchCbrt){
+        // Collect the dot products of a block, then take all their cube roots at once
+        T buffer[kSweepBlock];
+        for(std::size_t block = m_begin; block < m_end; block += kSweepBlock){
+            std::size_t len = std::min(kSweepBlock, m_end - block);
+            for(std::size_t j = 0; j < len; j++){
+                buffer[j] = DotProduct<Dot>(M, block+j, k);
+            }
+            CbrtBatch(buffer, len);
+            for(std::size_t j = 0; j < len; j++){
+                M.Store(block+j, k, buffer[j]);
+            }
+        }
+    } else {
+        for(std::size_t m = m_begin; m < m_end; m++){
+            M.Store(m, k, ComputeElement<Dot>(M, m, k));
+        }
+    }
+}
+
+/*!
+    \name DiagonalGrain
+    \param length number of elements on the diagonal
+    \param workers number of workers sharing it
+    \brief Contiguous chunk of a diagonal given to each worker
+    \note Rounded up to whole cache lines, so with PackedDiagonal no two workers write the same line
+*/
+template <typename T>
+inline std::size_t DiagonalGrain(std::size_t length, std::size_t workers){
+    constexpr std::size_t line = kCacheLine/sizeof(T);
+    std::size_t grain = (length + workers-1)/workers;
+    return (grain + line-1)/line*line;
+}
+
+/*!
+    \name ComputeWavefront
+    \brief Compute the whole wavefront sequentially, diagonal by diagonal
+*/
+template <typename Dot, typename Layout>
+void ComputeWavefront(Layout &M){
+    for(std::size_t k = 1; k < M.N; k++){
+        ComputeDiagonal<Dot>(M, k, 0, M.N-k);
+    }
+}
+
+} // namespace wavefront
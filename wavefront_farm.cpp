@@ -1,87 +1,37 @@
-#include <cmath>
-#include <mutex>
 #include <thread>
 #include <vector>
 #include <chrono>
-#include <iomanip>
-#include <fstream>
 #include <iostream>
-#include <algorithm>
-#include <condition_variable>
 
 #include <ff/ff.hpp>
 #include <ff/farm.hpp>
 #include <ff/parallel_for.hpp>
 
+#include "wavefront/schedule.hpp"
+#include "wavefront/wavefront.hpp"
+
 //#define DEBUG
 
-using vector_d = std::vector<double>;
+using Matrix = wavefront::RowMajorMirror<double>;
 
 typedef struct DiagonalTask{
-    int k;
-    int m;
-    int row;   // m+N;
-    int col_t; //(m+k)*N
-    vector_d &M;
-    std::atomic<int> &tasks;
+    uint64_t k;
+    uint64_t m_begin;               // Range [m_begin, m_end) of the k-th diagonal
+    uint64_t m_end;
+    Matrix *M;
 };
 
-// FillMatrix
-/*!
-    \name FillMatrix
-    \brief Fill the matrix M with the values
-    \note Fill the matrix M with the values
-*/
-vector_d* FillMatrix(vector_d *M, uint16_t N){
-    // Fill the diagonal elements (i,j) (where i == j) with (m+1)/N
-    for(int m = 0; m < N; m++){
-        (*M)[m*N+m] = static_cast<double>(m+1)/N; // M[m][m] = (m+1)/N
-    }
-    return M;
-}
-
-/*!
-    \name SaveMatrixPtrToFile
-    \param M vector_d M
-    \param N uint16_t N
-    \param filename string filename
-    \brief Save the matrix M to a file
-    \note Save the matrix M to a file with the name filename
-*/
-void SaveMatrixToFile(vector_d *M, uint16_t N, std::string filename){
-    std::ofstream file;
-    file.open(filename);
-    file << std::fixed << std::setprecision(6);
-    for(int i = 0; i < N; i++){
-        for(int j = 0; j < N; j++){
-            file << (*M)[i*N+j] << " ";  // M[i][j]
-        }
-        file << std::endl;
-    }
-    file.close();
-}
-
 /*!
     \name DiagonalWorker
     \brief DiagonalWorker
-    \note DiagonalWorker - Calculate the current element in the diagonal
+    \note DiagonalWorker - Calculate the elements of a range of the diagonal and send the task back
+          to the emitter as its completion notice
 */
-struct DiagonalWorker: ff::ff_node_t<DiagonalTask, void>{
-    void *svc(DiagonalTask *task){
-        double element = 0.0;
-        for(int i = 0; i < task->k; i++){
-            element += (task->M)[task->row+i+task->m] * (task->M)[task->col_t+i+task->m+1];
-        }
-        // Calculate the cubic root
-        double new_element = std::cbrt(element);
-        //Update the matrix
-        (task->M)[task->row+task->m+task->k] = new_element;
-        (task->M)[task->col_t+task->m] = new_element;
-
-        // Decrease the number of tasks
-        task->tasks--;
-        delete task;
-        return GO_ON;
+struct DiagonalWorker: ff::ff_node_t<DiagonalTask>{
+    DiagonalTask *svc(DiagonalTask *task){
+        // Calculate the dot products and the cubic roots and update the matrix
+        wavefront::ComputeDiagonal<wavefront::DefaultDot>(*task->M, task->k, task->m_begin, task->m_end);
+        return task;
     }
 };
 
@@ -89,36 +39,90 @@ struct DiagonalWorker: ff::ff_node_t<DiagonalTask, void>{
 /*!
     \name DiagonalEmitter
     \brief DiagonalEmitter
-    \note DiagonalEmitter - Emit the tasks for the workers to calculate the diagonal elements
+    \note DiagonalEmitter - Emit the tasks for the workers to calculate the diagonal elements.
+          Every diagonal is cut at the same multiples of the chunk width C, so chunk j of the k-th
+          diagonal, [j*C, (j+1)*C), only needs chunks j and j+1 of the (k-1)-th one (its elements
+          read (m, m+k-1) and (m+1, m+k), which transitively cover row m and column m+k).
+          The finished tasks come back on the feedback channel and release the chunks depending on
+          them, so the diagonals overlap instead of draining one by one. A column has at most one
+          chunk in flight. Once fewer than W columns are left (the last diagonals, with the longest
+          elements) a chunk is cut into parts for the idle workers, and the column is done when
+          all of its parts are back
 */
-struct DiagonalEmitter: ff::ff_monode_t<int, DiagonalTask>{
-    vector_d &M;
-    uint16_t N;
-
-    DiagonalEmitter(vector_d &M, uint16_t N) : M(M), N(N) {}
-
-    DiagonalTask *svc(int*){
-        // Send to the worker the index for the dot product zone
-        for(int k = 1; k < N; k++){
-            std::atomic<int> tasks(N-k);
-            for(int m = 0; m < N-k; m++){
-                ff_send_out(new DiagonalTask{k, m, m*N, (m+k)*N, M, std::ref(tasks)});
+struct DiagonalEmitter: ff::ff_monode_t<DiagonalTask>{
+    Matrix &M;
+    uint64_t N;
+    uint64_t C;
+    uint64_t W;
+    std::vector<uint64_t> done;         // done[j] = last diagonal finished in the j-th column
+    std::vector<uint64_t> pending;      // pending[j] = parts of the j-th column still computing
+    std::vector<DiagonalTask> pool;     // pool[j*W + p] = p-th part of the j-th column
+
+    DiagonalEmitter(Matrix &M, uint64_t N, uint64_t C, uint64_t W) : M(M), N(N), C(C), W(W) {}
+
+    // Chunk j of the k-th diagonal exists, is not yet sent and its inputs are done
+    bool Ready(uint64_t k, uint64_t j) const {
+        if(j*C >= N-k || done[j] != k-1){
+            return false;
+        }
+        // Element (j+1)*C of the (k-1)-th diagonal belongs to the next column
+        return (j+1)*C > N-k || done[j+1] >= k-1;
+    }
+
+    void Emit(uint64_t k, uint64_t j){
+        const uint64_t m_begin = j*C, m_end = std::min((j+1)*C, N-k);
+        // Share the workers among the columns left, keeping kMinChunkWork multiply-adds per part
+        const uint64_t columns = (N-k + C-1)/C;
+        const uint64_t amortised = (wavefront::kMinChunkWork + k-1)/k;
+        const uint64_t parts = std::max<uint64_t>(1, std::min(W/columns, (m_end - m_begin)/amortised));
+        pending[j] = parts;
+        for(uint64_t p = 0; p < parts; p++){
+            DiagonalTask *task = &pool[j*W + p];
+            *task = DiagonalTask{k, m_begin + (m_end - m_begin)*p/parts, m_begin + (m_end - m_begin)*(p+1)/parts, &M};
+            ff_send_out(task);
+        }
+    }
+
+    DiagonalTask *svc(DiagonalTask *task){
+        if(task == nullptr){
+            if(N < 2){
+                return EOS;
             }
-            // Wait for the tasks to finish
-            while (tasks.load() > 0){
-                std::this_thread::yield();
+            // The first diagonal only reads the main one
+            const uint64_t columns = (N-1 + C-1)/C;
+            done.assign(columns, 0);
+            pending.assign(columns, 0);
+            pool.resize(columns*W);
+            for(uint64_t j = 0; j < columns; j++){
+                Emit(1, j);
             }
+            return GO_ON;
+        }
+        const uint64_t k = task->k;
+        const uint64_t j = task->m_begin/C;
+        if(--pending[j] > 0){
+            return GO_ON;
+        }
+        done[j] = k;
+        // The last element depends on every other one
+        if(k == N-1){
+            return EOS;
+        }
+        if(Ready(k+1, j)){
+            Emit(k+1, j);
+        }
+        if(j > 0 && Ready(k+1, j-1)){
+            Emit(k+1, j-1);
         }
-        broadcast_task(EOS);
-        return EOS;
+        return GO_ON;
     }
 };
 
 
 int main(int argc, char* argv[]){
-    // N, W
-    if (argc != 3) {
-        std::cout << "Usage: " << argv[0] << "N (Size N*N) W (Workers)" << std::endl;
+    // N, W, C
+    if (argc != 3 && argc != 4) {
+        std::cout << "Usage: " << argv[0] << "N (Size N*N) W (Workers) [C (Chunk width)]" << std::endl;
         return -1;
     }
 
@@ -127,23 +131,38 @@ int main(int argc, char* argv[]){
         std::cout << "Max threads: " << max_threads << std::endl;
     #endif
 
-    const uint16_t N = atoi(argv[1]);
-    const uint16_t W = atoi(argv[2]);
+    const uint64_t N = std::strtoull(argv[1], nullptr, 10);
+    const uint64_t W = std::strtoull(argv[2], nullptr, 10);
 
+    if(N == 0){
+        std::cout << "N must be positive" << std::endl;
+        return -1;
+    }
+    if(W == 0){
+        std::cout << "The number of workers must be positive" << std::endl;
+        return -1;
+    }
     if(W > max_threads-1){
         std::cout << "The number of workers is higher than the number of threads available" << std::endl;
         return -1;
     }
+    // By default kChunksPerWorker cache-line aligned chunks per worker on the first diagonal
+    const uint64_t C = argc == 4 ? std::strtoull(argv[3], nullptr, 10)
+                                 : wavefront::DiagonalGrain<double>(N, wavefront::kChunksPerWorker*W);
+    if(C == 0){
+        std::cout << "The chunk width must be positive" << std::endl;
+        return -1;
+    }
 
     // Create and fill the matrix
     // Process to create the matrix
     auto start = std::chrono::high_resolution_clock::now();
 
-    vector_d M = vector_d(N*N, 0.0);
+    Matrix M(N);
     // Fill the matrix
-    FillMatrix(&M, N);
+    wavefront::FillMatrix(M);
     #ifdef DEBUG
-        SaveMatrixToFile(&M, N, "matrix_farm_normal.txt");
+        wavefront::SaveMatrixToFile(M, "matrix_farm_normal.txt");
     #endif
     auto stop = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> passed_time = stop - start;
@@ -153,7 +172,7 @@ int main(int argc, char* argv[]){
     ff::ffTime(ff::START_TIME);
     // Create workers
     std::vector<std::unique_ptr<ff::ff_node>> workers;
-    for(int i = 0; i < W; i++){
+    for(uint64_t i = 0; i < W; i++){
         workers.push_back(std::make_unique<DiagonalWorker>());
     }
     // Create the farm
@@ -162,7 +181,7 @@ int main(int argc, char* argv[]){
     farm.wrap_around();
     farm.set_scheduling_ondemand();
     // Create the emitter
-    DiagonalEmitter emitter(M, N);
+    DiagonalEmitter emitter(M, N, C, W);
     //
     farm.add_emitter(emitter);
     // Run the farm
@@ -172,7 +191,7 @@ int main(int argc, char* argv[]){
     }
     
     #ifdef DEBUG
-        SaveMatrixToFile(&M, N, "matrix_farm_results.txt");
+        wavefront::SaveMatrixToFile(M, "matrix_farm_results.txt");
     #endif
     ff::ffTime(ff::STOP_TIME);
     std::cout << "Time passed to calculate the wavefront: " << ff::ffTime(ff::GET_TIME)/1000.0 << " seconds" << std::endl;
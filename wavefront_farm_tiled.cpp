@@ -0,0 +1,152 @@
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <iostream>
+
+#include <ff/ff.hpp>
+#include <ff/farm.hpp>
+
+#include "wavefront/tiles.hpp"
+
+//#define DEBUG
+
+using Matrix = wavefront::RowMajorMirror<double>;
+using wavefront::Tile;
+
+/*!
+    \name TileWorker
+    \brief TileWorker
+    \note TileWorker - Calculate every element of a tile and send it back to the emitter
+*/
+struct TileWorker: ff::ff_node_t<Tile>{
+    Matrix &M;
+    uint64_t B;
+
+    TileWorker(Matrix &M, uint64_t B) : M(M), B(B) {}
+
+    Tile *svc(Tile *tile){
+        wavefront::ComputeTile<wavefront::DefaultDot>(M, B, *tile);
+        return tile;
+    }
+};
+
+
+/*!
+    \name TileEmitter
+    \brief TileEmitter
+    \note TileEmitter - Emit the tiles whose left and below neighbours are done, the finished tiles
+          come back on the feedback channel and release the tiles depending on them
+*/
+struct TileEmitter: ff::ff_monode_t<Tile>{
+    wavefront::TileGraph graph;
+    std::vector<Tile> tiles;            // One task per tile, allocated once
+    std::vector<Tile> ready;
+    uint64_t done = 0;
+
+    TileEmitter(uint64_t N, uint64_t B) : graph(N, B), tiles(graph.Count()) {}
+
+    void Send(Tile tile){
+        Tile *task = &tiles[graph.Index(tile)];
+        *task = tile;
+        ff_send_out(task);
+    }
+
+    Tile *svc(Tile *tile){
+        if(tile == nullptr){
+            // An empty matrix has no tile, nothing would ever come back
+            if(graph.Count() == 0){
+                return EOS;
+            }
+            // Start with the tiles on the main diagonal
+            for(Tile root : graph.Roots()){
+                Send(root);
+            }
+            return GO_ON;
+        }
+        // Release the right and above neighbours of the finished tile
+        ready.clear();
+        graph.Complete(*tile, ready);
+        for(Tile next : ready){
+            Send(next);
+        }
+        if(++done == graph.Count()){
+            return EOS;
+        }
+        return GO_ON;
+    }
+};
+
+
+int main(int argc, char* argv[]){
+    // N, W, B
+    if (argc != 3 && argc != 4) {
+        std::cout << "Usage: " << argv[0] << "N (Size N*N) W (Workers) [B (Tile size, default 128)]" << std::endl;
+        return -1;
+    }
+
+    unsigned int max_threads = std::thread::hardware_concurrency();
+    #ifdef DEBUG
+        std::cout << "Max threads: " << max_threads << std::endl;
+    #endif
+
+    const uint64_t N = std::strtoull(argv[1], nullptr, 10);
+    const uint64_t W = std::strtoull(argv[2], nullptr, 10);
+    const uint64_t B = argc == 4 ? std::strtoull(argv[3], nullptr, 10) : 128;
+
+    if(W == 0){
+        std::cout << "The number of workers must be positive" << std::endl;
+        return -1;
+    }
+    if(W > max_threads-1){
+        std::cout << "The number of workers is higher than the number of threads available" << std::endl;
+        return -1;
+    }
+    if(B == 0){
+        std::cout << "The tile size must be positive" << std::endl;
+        return -1;
+    }
+
+    // Create and fill the matrix
+    // Process to create the matrix
+    auto start = std::chrono::high_resolution_clock::now();
+
+    Matrix M(N);
+    // Fill the matrix
+    wavefront::FillMatrix(M);
+    #ifdef DEBUG
+        wavefront::SaveMatrixToFile(M, "matrix_farm_tiled_normal.txt");
+    #endif
+    auto stop = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> passed_time = stop - start;
+    std::cout << "Matrix created and filled in: " << passed_time.count() << " seconds" << std::endl;
+
+    // Start the timer
+    ff::ffTime(ff::START_TIME);
+    // Create workers
+    std::vector<std::unique_ptr<ff::ff_node>> workers;
+    for(int i = 0; i < W; i++){
+        workers.push_back(std::make_unique<TileWorker>(M, B));
+    }
+    // Create the farm
+    ff::ff_Farm<Tile> farm(std::move(workers));
+    farm.remove_collector();
+    farm.wrap_around();
+    farm.set_scheduling_ondemand();
+    // Create the emitter
+    TileEmitter emitter(N, B);
+    //
+    farm.add_emitter(emitter);
+    // Run the farm
+    if(farm.run_and_wait_end() < 0){
+        ff::error("Running farm");
+        return -1;
+    }
+
+    #ifdef DEBUG
+        wavefront::SaveMatrixToFile(M, "matrix_farm_tiled_results.txt");
+    #endif
+    ff::ffTime(ff::STOP_TIME);
+    std::cout << "Time passed to calculate the wavefront: " << ff::ffTime(ff::GET_TIME)/1000.0 << " seconds" << std::endl;
+    return 0;
+
+}
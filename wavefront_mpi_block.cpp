@@ -0,0 +1,216 @@
+#include <mpi.h>
+#include <omp.h>
+#include <limits>
+#include <array>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+
+#include "wavefront/wavefront.hpp"
+
+//#define DEBUG
+
+using Matrix = wavefront::PackedDiagonal<double>;
+using Kernel = wavefront::BatchCbrt<wavefront::DefaultDot>;
+
+/*!
+    \name OwnedRange
+    \param length number of elements on the diagonal (N-k)
+    \param rank process rank
+    \param size number of processes
+    \brief First element of the contiguous block of the diagonal owned by rank (and rank+1's at rank+1)
+*/
+uint64_t OwnedRange(uint64_t length, int rank, int size){
+    return length*rank/size;
+}
+
+/*!
+    \name DiagonalExchange
+    \brief Non-blocking gather of one diagonal, with its own counts, displacements and receive
+           buffer so that two diagonals can be in flight
+    \note The blocks are received into buffer rather than in place: the own block of the diagonal
+           stays readable (it is only the send buffer) while the gather is pending
+*/
+struct DiagonalExchange{
+    uint64_t k = 0;                     // Diagonal in flight, 0 when idle
+    std::vector<int> counts;
+    std::vector<int> displs;
+    std::vector<double> buffer;
+    MPI_Request request = MPI_REQUEST_NULL;
+};
+
+/*!
+    \name StartExchange
+    \param M matrix, the own block of the k-th diagonal is computed
+    \param k diagonal index
+    \param rank, size process rank and number of processes
+    \param exchange buffers and request of this diagonal, idle
+    \brief Start gathering the blocks of all the processes, FinishExchange stores them in the k-th
+           diagonal of every process
+*/
+void StartExchange(Matrix &M, uint64_t k, int rank, int size, DiagonalExchange &exchange){
+    const uint64_t length = M.N-k;
+    exchange.k = k;
+    exchange.counts.resize(size);
+    exchange.displs.resize(size);
+    exchange.buffer.resize(length);
+    for(int r = 0; r < size; r++){
+        exchange.displs[r] = OwnedRange(length, r, size);
+        exchange.counts[r] = OwnedRange(length, r+1, size) - exchange.displs[r];
+    }
+    MPI_Iallgatherv(M.Diagonal(k) + exchange.displs[rank], exchange.counts[rank], MPI_DOUBLE, exchange.buffer.data(),
+                    exchange.counts.data(), exchange.displs.data(), MPI_DOUBLE, MPI_COMM_WORLD, &exchange.request);
+}
+
+/*!
+    \name FinishExchange
+    \brief Wait for the pending gather (if any) and copy the blocks of the other processes into the diagonal
+*/
+void FinishExchange(Matrix &M, int rank, DiagonalExchange &exchange){
+    if(exchange.k == 0){
+        return;
+    }
+    MPI_Wait(&exchange.request, MPI_STATUS_IGNORE);
+    double *diagonal = M.Diagonal(exchange.k);
+    const uint64_t own_begin = exchange.displs[rank], own_end = own_begin + exchange.counts[rank];
+    std::copy(exchange.buffer.begin(), exchange.buffer.begin() + own_begin, diagonal);
+    std::copy(exchange.buffer.begin() + own_end, exchange.buffer.end(), diagonal + own_end);
+    exchange.k = 0;
+}
+
+/*!
+    \name ComputeBlock
+    \param M matrix
+    \param k diagonal index
+    \param m_begin, m_end elements of the k-th diagonal to compute
+    \param threads threads of this process
+    \param pending exchange in flight, or nullptr
+    \brief Compute [m_begin, m_end) of the k-th diagonal with the threads of the process, one
+           contiguous, cache-line aligned chunk per thread swept block by block
+    \note The master thread lets MPI progress the pending exchange between two of its sweep blocks
+           (MPI_THREAD_FUNNELED)
+*/
+void ComputeBlock(Matrix &M, uint64_t k, uint64_t m_begin, uint64_t m_end, int threads, DiagonalExchange *pending){
+    if(m_begin >= m_end){
+        return;
+    }
+    // Chunks are cut at absolute multiples of the grain, a whole number of cache lines: a
+    // PackedDiagonal diagonal starts on a line, so two threads never write the same line
+    const uint64_t base = m_begin / Matrix::kLine * Matrix::kLine;
+    const uint64_t chunk = wavefront::DiagonalGrain<double>(m_end - base, threads);
+    const uint64_t chunks = (m_end - base + chunk-1) / chunk;
+    #pragma omp parallel for schedule(static) num_threads(threads) if(chunks > 1)
+    for(uint64_t c = 0; c < chunks; c++){
+        const uint64_t chunk_begin = std::max(base + c*chunk, m_begin), chunk_end = std::min(base + (c+1)*chunk, m_end);
+        for(uint64_t block = chunk_begin; block < chunk_end; block += wavefront::kSweepBlock){
+            wavefront::ComputeDiagonal<Kernel>(M, k, block, std::min(block + wavefront::kSweepBlock, chunk_end));
+            if(pending != nullptr && omp_get_thread_num() == 0){
+                int done;
+                MPI_Test(&pending->request, &done, MPI_STATUS_IGNORE);
+            }
+        }
+    }
+}
+
+
+int main(int argc, char* argv[]){
+
+    // Without --blocking the exchange of a diagonal overlaps the computation of the next one
+    const bool overlap = std::string(argv[argc-1]) != "--blocking";
+    const int positional = overlap ? argc : argc-1;
+    if(positional != 2 && positional != 3){
+        printf("Usage: %s <N> [T (Threads per process, default OMP_NUM_THREADS)] [--blocking]\n", argv[0]);
+        return -1;
+    }
+    int threads = positional == 3 ? std::atoi(argv[2]) : omp_get_max_threads();
+
+    uint64_t N = std::strtoull(argv[1], nullptr, 10);
+    if(N <= 1 || threads <= 0){
+        printf("N must be greater than 1 and T positive\n");
+        return -1;
+    }
+    // MPI counts and displacements are int
+    if(N > static_cast<uint64_t>(std::numeric_limits<int>::max())){
+        printf("N must be at most %d\n", std::numeric_limits<int>::max());
+        return -1;
+    }
+    //Set precison
+    std::cout << std::fixed << std::showpoint;
+    std::cout << std::setprecision(6);
+
+    //
+    // Only the master thread of a process calls MPI
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided); // Initialize the MPI environment
+
+    int rank, number_of_processes;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);                      // Get the rank of the process
+    MPI_Comm_size(MPI_COMM_WORLD, &number_of_processes);       // Get the number of processes
+
+    if(provided < MPI_THREAD_FUNNELED){
+        threads = 1;
+    }
+
+    //Timer to measure the creation and filling of the matrix
+    double start_mpi_timer = MPI_Wtime();
+    double end_mpi_timer;
+    // Every process builds the same initial matrix
+    Matrix M(N);
+    wavefront::FillMatrix(M);
+    if (rank == 0){
+        #ifdef DEBUG
+            wavefront::SaveMatrixToFile(M, "matrix_mpi_block_normal.txt");
+        #endif
+        end_mpi_timer = MPI_Wtime();
+        double passed_time = end_mpi_timer - start_mpi_timer;
+        std::cout << "Threads per process: " << threads << std::endl;
+        std::cout << "Matrix created and filled in: " << passed_time << std::endl;
+    }
+
+    //Timer to measure the wavefront algorithm
+    MPI_Barrier(MPI_COMM_WORLD);
+    start_mpi_timer = MPI_Wtime();
+
+    // Double-buffered exchanges: diagonal k is computed while diagonal k-1 is in flight
+    std::array<DiagonalExchange, 2> exchanges;
+    // Iterate over the k (diagonal distance)
+    for (uint64_t k = 1; k < N; k++){
+        // Each process computes its own contiguous block of the diagonal with its threads...
+        uint64_t begin = OwnedRange(N-k, rank, number_of_processes);
+        uint64_t end = OwnedRange(N-k, rank+1, number_of_processes);
+        DiagonalExchange &previous = exchanges[(k-1) % 2];
+        if(overlap && k > 1){
+            // Element m only reads elements m and m+1 of the (k-1)-th diagonal, plus older
+            // diagonals already gathered: the elements with both in the own block go first
+            uint64_t previous_begin = OwnedRange(N-k+1, rank, number_of_processes);
+            uint64_t previous_end = OwnedRange(N-k+1, rank+1, number_of_processes);
+            uint64_t early_begin = std::clamp(previous_begin, begin, end);
+            uint64_t early_end = std::clamp(previous_end > 0 ? previous_end-1 : 0, early_begin, end);
+            ComputeBlock(M, k, early_begin, early_end, threads, &previous);
+            FinishExchange(M, rank, previous);
+            wavefront::ComputeDiagonal<Kernel>(M, k, begin, early_begin);
+            wavefront::ComputeDiagonal<Kernel>(M, k, early_end, end);
+        } else {
+            FinishExchange(M, rank, previous);
+            ComputeBlock(M, k, begin, end, threads, nullptr);
+        }
+        // ...and one collective hands every block to everybody
+        StartExchange(M, k, rank, number_of_processes, exchanges[k % 2]);
+    }
+    FinishExchange(M, rank, exchanges[(N-1) % 2]);
+
+    if (rank == 0){
+        #ifdef DEBUG
+            wavefront::SaveMatrixToFile(M, "matrix_mpi_block_results.txt");
+        #endif
+        end_mpi_timer = MPI_Wtime();
+        double passed_time = end_mpi_timer - start_mpi_timer;
+        std::cout << "Time to compute the matrix: " << passed_time << std::endl;
+    }
+    MPI_Finalize();                                                     // Finalize the MPI environment
+    return 0;
+}
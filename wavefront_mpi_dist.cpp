@@ -0,0 +1,217 @@
+#include <mpi.h>
+#include <limits>
+#include <vector>
+#include <iomanip>
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+
+#include "wavefront/panels.hpp"
+
+//#define DEBUG
+
+using Panels = wavefront::DistributedPanels<double>;
+using wavefront::Tile;
+
+/*!
+    \name ExchangeTiles
+    \param panels local panels, the own tiles of the d-th tile diagonal are computed
+    \param d tile diagonal
+    \param comm grid row (rows == true) or grid column communicator
+    \param rows unpack into the row panels (grid row) or into the column panels (grid column)
+    \param send, recv, counts, displs scratch buffers
+    \brief Share the tiles of the d-th tile diagonal among the processes of a grid row or column
+*/
+void ExchangeTiles(Panels &panels, uint64_t d, MPI_Comm comm, bool rows,
+                   std::vector<double> &send, std::vector<double> &recv, std::vector<int> &counts, std::vector<int> &displs){
+    const wavefront::TileGrid &grid = panels.grid;
+    const uint64_t tile_size = panels.TileSize();
+    const int members = rows ? grid.Pc : grid.Pr;
+    // Members of a grid row differ in pc, members of a grid column in pr
+    auto position = [&](int q){ return rows ? std::make_pair(panels.pr, uint64_t(q)) : std::make_pair(uint64_t(q), panels.pc); };
+
+    int total = 0;
+    for(int q = 0; q < members; q++){
+        auto [pr, pc] = position(q);
+        counts[q] = grid.CountOwned(d, pr, pc)*tile_size;
+        displs[q] = total;
+        total += counts[q];
+    }
+    recv.resize(total);
+    int own = rows ? panels.pc : panels.pr;
+    MPI_Allgatherv(send.data(), counts[own], MPI_DOUBLE, recv.data(), counts.data(), displs.data(), MPI_DOUBLE, comm);
+
+    // The own tiles are already in place
+    for(int q = 0; q < members; q++){
+        if(q == own){
+            continue;
+        }
+        auto [pr, pc] = position(q);
+        const double *in = recv.data() + displs[q];
+        grid.ForOwned(d, pr, pc, [&](Tile tile){
+            if(rows){
+                panels.UnpackRow(tile, in);
+            } else {
+                panels.UnpackColumn(tile, in);
+            }
+            in += tile_size;
+        });
+    }
+}
+
+/*!
+    \name ChooseGrid
+    \param size number of processes
+    \param dims filled with Pr, Pc (Pr >= Pc, Pr*Pc <= size)
+    \brief Process grid with the smallest panels: a process stores about N*N/2 * (1/Pr + 1/Pc)
+           elements, on ties the grid using more processes
+    \note MPI_Dims_create would turn a prime size into size x 1, where every process stores every
+           tile column. A squarer grid that leaves a few processes idle is preferred instead
+*/
+void ChooseGrid(int size, int dims[2]){
+    double best = 0;
+    for(int Pc = 1; Pc*Pc <= size; Pc++){
+        const int Pr = size / Pc;
+        const double footprint = 1.0/Pr + 1.0/Pc;
+        if(Pc == 1 || footprint < best || (footprint == best && Pr*Pc > dims[0]*dims[1])){
+            best = footprint;
+            dims[0] = Pr;
+            dims[1] = Pc;
+        }
+    }
+}
+
+/*!
+    \name GatherMatrix
+    \brief Collect the row panels of the first grid column on rank 0 as a full matrix (DEBUG only)
+*/
+wavefront::RowMajor<double> GatherMatrix(Panels &panels, MPI_Comm column_comm){
+    const wavefront::TileGrid &grid = panels.grid;
+    wavefront::RowMajor<double> M(panels.pr == 0 && panels.pc == 0 ? grid.N : 0);
+    if(panels.pc != 0){
+        return M;
+    }
+    if(panels.pr != 0){
+        for(auto &panel : panels.rows){
+            MPI_Send(panel.data(), panel.size(), MPI_DOUBLE, 0, 0, column_comm);
+        }
+        return M;
+    }
+    for(uint64_t I = 0; I < grid.tiles; I++){
+        std::vector<double> panel(panels.RowHeight(I)*panels.RowWidth(I));
+        if(I % grid.Pr == 0){
+            std::copy(panels.rows[I/grid.Pr].begin(), panels.rows[I/grid.Pr].end(), panel.begin());
+        } else {
+            MPI_Recv(panel.data(), panel.size(), MPI_DOUBLE, I % grid.Pr, 0, column_comm, MPI_STATUS_IGNORE);
+        }
+        for(uint64_t r = 0; r < panels.RowHeight(I); r++){
+            uint64_t m = I*grid.B + r;
+            for(uint64_t c = m; c < grid.N; c++){
+                M.Store(m, c-m, panel[r*panels.RowWidth(I) + (c - I*grid.B)]);
+            }
+        }
+    }
+    return M;
+}
+
+
+int main(int argc, char* argv[]){
+
+    if(argc != 2 && argc != 3){
+        printf("Usage: %s <N> [B (Tile size, default 64)]\n", argv[0]);
+        return -1;
+    }
+
+    uint64_t N = std::strtoull(argv[1], nullptr, 10);
+    uint64_t B = argc == 3 ? std::strtoull(argv[2], nullptr, 10) : 64;
+    if(N <= 1 || B == 0){
+        printf("N must be greater than 1 and B positive\n");
+        return -1;
+    }
+    // MPI counts are int: a process sends at most N/B tiles of B*B elements per tile diagonal
+    if((N/B + 1)*B*B > static_cast<uint64_t>(std::numeric_limits<int>::max())){
+        printf("N*B must be less than %d\n", std::numeric_limits<int>::max());
+        return -1;
+    }
+    //Set precison
+    std::cout << std::fixed << std::showpoint;
+    std::cout << std::setprecision(6);
+
+    //
+    MPI_Init(&argc, &argv);                                    // Initialize the MPI environment
+
+    int rank, number_of_processes;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);                      // Get the rank of the process
+    MPI_Comm_size(MPI_COMM_WORLD, &number_of_processes);       // Get the number of processes
+
+    // Pr x Pc process grid, the processes left out of it stay idle
+    int dims[2];
+    ChooseGrid(number_of_processes, dims);
+    MPI_Comm grid_comm;
+    MPI_Comm_split(MPI_COMM_WORLD, rank < dims[0]*dims[1] ? 0 : MPI_UNDEFINED, rank, &grid_comm);
+    if(grid_comm == MPI_COMM_NULL){
+        MPI_Finalize();
+        return 0;
+    }
+    // The processes of a grid row and of a grid column get a communicator
+    const uint64_t pr = rank / dims[1], pc = rank % dims[1];
+    MPI_Comm row_comm, column_comm;
+    MPI_Comm_split(grid_comm, pr, pc, &row_comm);
+    MPI_Comm_split(grid_comm, pc, pr, &column_comm);
+
+    //Timer to measure the creation and filling of the matrix
+    double start_mpi_timer = MPI_Wtime();
+    double end_mpi_timer;
+    // Every process only stores its tile rows and tile columns
+    const wavefront::TileGrid grid(N, B, dims[0], dims[1]);
+    Panels panels(grid, pr, pc);
+    panels.Fill();
+    if (rank == 0){
+        end_mpi_timer = MPI_Wtime();
+        double passed_time = end_mpi_timer - start_mpi_timer;
+        std::cout << "Process grid: " << dims[0] << "x" << dims[1] << std::endl;
+        if(dims[0]*dims[1] < number_of_processes){
+            std::cout << "Idle processes: " << number_of_processes - dims[0]*dims[1] << std::endl;
+        }
+        if(dims[1] == 1 && number_of_processes > 1){
+            std::cout << "Warning: with one grid column every process stores all the tile columns" << std::endl;
+        }
+        std::cout << "Matrix created and filled in: " << passed_time << std::endl;
+    }
+
+    //Timer to measure the wavefront algorithm
+    MPI_Barrier(grid_comm);
+    start_mpi_timer = MPI_Wtime();
+
+    std::vector<double> send, recv;
+    std::vector<int> counts(std::max(dims[0], dims[1])), displs(std::max(dims[0], dims[1]));
+    // Iterate over the tile diagonals: a tile only needs tiles of the previous ones
+    for (uint64_t d = 0; d < grid.tiles; d++){
+        send.clear();
+        grid.ForOwned(d, pr, pc, [&](Tile tile){
+            panels.ComputeTile<wavefront::DefaultDot>(tile);
+            send.resize(send.size() + panels.TileSize());
+            panels.Pack(tile, send.data() + send.size() - panels.TileSize());
+        });
+        // The new tiles go to the processes sharing their tile row and their tile column
+        ExchangeTiles(panels, d, row_comm, true, send, recv, counts, displs);
+        ExchangeTiles(panels, d, column_comm, false, send, recv, counts, displs);
+    }
+
+    #ifdef DEBUG
+        wavefront::RowMajor<double> M = GatherMatrix(panels, column_comm);
+    #endif
+    if (rank == 0){
+        #ifdef DEBUG
+            wavefront::SaveMatrixToFile(M, "matrix_mpi_dist_results.txt");
+        #endif
+        end_mpi_timer = MPI_Wtime();
+        double passed_time = end_mpi_timer - start_mpi_timer;
+        std::cout << "Time to compute the matrix: " << passed_time << std::endl;
+    }
+    MPI_Comm_free(&row_comm);
+    MPI_Comm_free(&column_comm);
+    MPI_Comm_free(&grid_comm);
+    MPI_Finalize();                                                     // Finalize the MPI environment
+    return 0;
+}
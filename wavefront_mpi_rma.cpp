@@ -0,0 +1,132 @@
+#include <mpi.h>
+#include <limits>
+#include <iomanip>
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+
+#include "wavefront/wavefront.hpp"
+
+//#define DEBUG
+
+using Matrix = wavefront::PackedDiagonal<double>;
+using Kernel = wavefront::BatchCbrt<wavefront::DefaultDot>;
+
+/*!
+    \name OwnedRange
+    \param length number of elements on the diagonal (N-k)
+    \param rank process rank
+    \param size number of processes
+    \brief First element of the contiguous block of the diagonal owned by rank (and rank+1's at rank+1)
+*/
+uint64_t OwnedRange(uint64_t length, int rank, int size){
+    return length*rank/size;
+}
+
+/*!
+    \name PutBlock
+    \param M matrix, exposed through window
+    \param k diagonal index
+    \param begin, end own block of the k-th diagonal, computed
+    \param rank, size process rank and number of processes
+    \param window window over the storage of M
+    \brief Write the own block of the k-th diagonal at the same place in the matrix of every other process
+    \note Completed by the next fence
+*/
+void PutBlock(Matrix &M, uint64_t k, uint64_t begin, uint64_t end, int rank, int size, MPI_Win window){
+    if(begin == end){
+        return;
+    }
+    const MPI_Aint displacement = M.Offset(k) + begin;
+    for(int r = 0; r < size; r++){
+        if(r != rank){
+            MPI_Put(M.Diagonal(k) + begin, end - begin, MPI_DOUBLE, r, displacement, end - begin, MPI_DOUBLE, window);
+        }
+    }
+}
+
+
+int main(int argc, char* argv[]){
+
+    if(argc != 2){
+        printf("Usage: %s <N>\n", argv[0]);
+        return -1;
+    }
+
+    uint64_t N = std::strtoull(argv[1], nullptr, 10);
+    if(N <= 1){
+        printf("N must be greater than 1\n");
+        return -1;
+    }
+    // MPI counts are int
+    if(N > static_cast<uint64_t>(std::numeric_limits<int>::max())){
+        printf("N must be at most %d\n", std::numeric_limits<int>::max());
+        return -1;
+    }
+    //Set precison
+    std::cout << std::fixed << std::showpoint;
+    std::cout << std::setprecision(6);
+
+    //
+    MPI_Init(&argc, &argv);                                    // Initialize the MPI environment
+
+    int rank, number_of_processes;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);                      // Get the rank of the process
+    MPI_Comm_size(MPI_COMM_WORLD, &number_of_processes);       // Get the number of processes
+
+    //Timer to measure the creation and filling of the matrix
+    double start_mpi_timer = MPI_Wtime();
+    double end_mpi_timer;
+    // Every process builds the same initial matrix and exposes all of it, the others write their blocks into it
+    Matrix M(N);
+    wavefront::FillMatrix(M);
+    // A single process has nothing to exchange (and Open MPI finds no RMA component for it)
+    const bool exchange = number_of_processes > 1;
+    MPI_Win window = MPI_WIN_NULL;
+    if(exchange){
+        MPI_Win_create(M.data.data(), M.data.size()*sizeof(double), sizeof(double), MPI_INFO_NULL, MPI_COMM_WORLD, &window);
+    }
+    if (rank == 0){
+        #ifdef DEBUG
+            wavefront::SaveMatrixToFile(M, "matrix_mpi_rma_normal.txt");
+        #endif
+        end_mpi_timer = MPI_Wtime();
+        double passed_time = end_mpi_timer - start_mpi_timer;
+        std::cout << "Matrix created and filled in: " << passed_time << std::endl;
+    }
+
+    //Timer to measure the wavefront algorithm
+    MPI_Barrier(MPI_COMM_WORLD);
+    start_mpi_timer = MPI_Wtime();
+
+    if(exchange){
+        MPI_Win_fence(MPI_MODE_NOPRECEDE, window);
+    }
+    // Iterate over the k (diagonal distance)
+    for (uint64_t k = 1; k < N; k++){
+        // Each process computes its own contiguous block of the diagonal...
+        uint64_t begin = OwnedRange(N-k, rank, number_of_processes);
+        uint64_t end = OwnedRange(N-k, rank+1, number_of_processes);
+        wavefront::ComputeDiagonal<Kernel>(M, k, begin, end);
+        // ...puts it straight into the other processes' matrices, and one fence per diagonal
+        // completes every put before anybody reads the diagonal
+        if(exchange){
+            PutBlock(M, k, begin, end, rank, number_of_processes, window);
+            MPI_Win_fence(k == N-1 ? MPI_MODE_NOSUCCEED : 0, window);
+        }
+    }
+
+    if (rank == 0){
+        #ifdef DEBUG
+            wavefront::SaveMatrixToFile(M, "matrix_mpi_rma_results.txt");
+        #endif
+        end_mpi_timer = MPI_Wtime();
+        double passed_time = end_mpi_timer - start_mpi_timer;
+        std::cout << "Time to compute the matrix: " << passed_time << std::endl;
+    }
+    if(exchange){
+        MPI_Win_free(&window);
+    }
+    MPI_Finalize();                                                     // Finalize the MPI environment
+    return 0;
+}
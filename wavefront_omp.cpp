@@ -0,0 +1,81 @@
+#include <vector>
+#include <chrono>
+#include <iostream>
+
+#include <omp.h>
+
+#include "wavefront/tiles.hpp"
+
+//#define DEBUG
+
+using Matrix = wavefront::RowMajorMirror<double>;
+using wavefront::Tile;
+
+int main(int argc, char* argv[]){
+    // N, W, B
+    if (argc != 3 && argc != 4) {
+        std::cout << "Usage: " << argv[0] << "N (Size N*N) W (Workers) [B (Tile size, default 128)]" << std::endl;
+        return -1;
+    }
+
+    const uint64_t N = std::strtoull(argv[1], nullptr, 10);
+    const int W = atoi(argv[2]);
+    const uint64_t B = argc == 4 ? std::strtoull(argv[3], nullptr, 10) : 128;
+
+    if(W <= 0 || B == 0){
+        std::cout << "The number of workers and the tile size must be positive" << std::endl;
+        return -1;
+    }
+
+    // Create and fill the matrix
+    // Process to create the matrix
+    auto start = std::chrono::high_resolution_clock::now();
+
+    Matrix M(N);
+    // Fill the matrix
+    wavefront::FillMatrix(M);
+    #ifdef DEBUG
+        wavefront::SaveMatrixToFile(M, "matrix_omp_normal.txt");
+    #endif
+    auto stop = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> passed_time = stop - start;
+    std::cout << "Matrix created and filled in: " << passed_time.count() << " seconds" << std::endl;
+
+    // Start the timer
+    double start_wavefront = omp_get_wtime();
+
+    // One task per tile, the dependencies are expressed on one tag per tile:
+    // tile (I, J) reads its left (I, J-1) and below (I+1, J) neighbours
+    const wavefront::TileGraph graph(N, B);
+    const uint64_t T = graph.tiles_per_side;
+    std::vector<char> tags(graph.Count());
+    [[maybe_unused]] char *tag = tags.data();        // Only read by the depend clauses
+
+    #pragma omp parallel num_threads(W)
+    #pragma omp single
+    {
+        // Tiles are created in order of J - I, so every producer exists before its consumers
+        for(uint64_t d = 0; d < T; d++){
+            for(uint64_t I = 0; I + d < T; I++){
+                const uint64_t J = I + d;
+                const uint64_t self = graph.Index({I, J});
+                if(d == 0){
+                    #pragma omp task firstprivate(I, J) depend(out: tag[self])
+                    wavefront::ComputeTile<wavefront::DefaultDot>(M, B, Tile{I, J});
+                } else {
+                    const uint64_t left = graph.Index({I, J-1});
+                    const uint64_t below = graph.Index({I+1, J});
+                    #pragma omp task firstprivate(I, J) depend(in: tag[left], tag[below]) depend(out: tag[self])
+                    wavefront::ComputeTile<wavefront::DefaultDot>(M, B, Tile{I, J});
+                }
+            }
+        }
+    }
+
+    #ifdef DEBUG
+        wavefront::SaveMatrixToFile(M, "matrix_omp_results.txt");
+    #endif
+    double stop_wavefront = omp_get_wtime();
+    std::cout << "Time passed to calculate the wavefront: " << stop_wavefront - start_wavefront << " seconds" << std::endl;
+    return 0;
+}
@@ -1,7 +1,5 @@
-#include <vector>
+#include <limits>
 #include <chrono>
-#include <iomanip>
-#include <fstream>
 #include <iostream>
 
 
@@ -9,64 +7,38 @@
 #include <ff/farm.hpp>
 #include <ff/parallel_for.hpp>
 
-//#define DEBUG
-
-using vector_d = std::vector<double>;
+#include "wavefront/steal.hpp"
+#include "wavefront/schedule.hpp"
+#include "wavefront/wavefront.hpp"
 
-// FillMatrix
-/*!
-    \name FillMatrix
-    \brief Fill the matrix M with the values
-    \note Fill the matrix M with the values
-*/
-vector_d* FillMatrix(vector_d *M, uint16_t N){
-    // Fill the diagonal elements (i,j) (where i == j) with (m+1)/N
-    for(int m = 0; m < N; m++){
-        (*M)[m*N+m] = static_cast<double>(m+1)/N; // M[m][m] = (m+1)/N
-    }
-    return M;
-}
+//#define DEBUG
 
-/*!
-    \name SaveMatrixPtrToFile
-    \param M shared_ptr<vector_d> M
-    \param N uint16_t N
-    \param filename string filename
-    \brief Save the matrix M to a file
-    \note Save the matrix M to a file with the name filename
-*/
-void SaveMatrixToFile(vector_d *M, uint16_t N, std::string filename){
-    std::ofstream file;
-    file.open(filename);
-    file << std::fixed << std::setprecision(6);
-    for(int i = 0; i < N; i++){
-        for(int j = 0; j < N; j++){
-            file << (*M)[i*N+j] << " ";  // M[i][j]
-        }
-        file << std::endl;
-    }
-    file.close();
-}
+using Matrix = wavefront::RowMajor<double>;
 
 
 int main(int argc, char* argv[]){
-    // N, W
-    if (argc != 3) {
-        std::cout << "Usage: " << argv[0] << "N (Size N*N) W (Workers)" << std::endl;
+    // N, W, scheduling options
+    wavefront::Schedule schedule;
+    if (argc < 3 || !wavefront::ParseSchedule(argc, argv, 3, schedule)) {
+        std::cout << "Usage: " << argv[0] << "N (Size N*N) W (Workers) [--schedule=default|static|dynamic|adaptive] [--backend=fastflow|steal] [--grain=G] [--spinwait] [--spinbarrier]" << std::endl;
         return -1;
     }
 
-    const uint16_t N = atoi(argv[1]);
-    const uint16_t W = atoi(argv[2]);
+    const uint64_t N = std::strtoull(argv[1], nullptr, 10);
+    const uint64_t W = std::strtoull(argv[2], nullptr, 10);
+    if(W == 0 || W > std::numeric_limits<uint16_t>::max()){
+        std::cout << "The number of workers must be between 1 and " << std::numeric_limits<uint16_t>::max() << std::endl;
+        return -1;
+    }
   
     // Process to create the matrix
     auto start = std::chrono::high_resolution_clock::now();
 
-    vector_d M = vector_d(N*N, 0.0);
+    Matrix M(N);
     // Fill the matrix
-    FillMatrix(&M, N);
-    #ifdef DEBUG-
-        SaveMatrixToFile(&M, N, "matrix_pf_normal.txt");
+    wavefront::FillMatrix(M);
+    #ifdef DEBUG
+        wavefront::SaveMatrixToFile(M, "matrix_pf_normal.txt");
     #endif
     auto stop = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> passed_time = stop - start;
@@ -75,19 +47,24 @@ int main(int argc, char* argv[]){
     // Start the timer
     ff::ffTime(ff::START_TIME);
 
-    ff::ParallelFor pf(W);
-    for (int k = 1; k < N; k++){
-        pf.parallel_for(0, N-k, [&](const long m){
-            double element = 0.0;
-            for(int i = 0; i < k; i++){
-                element += M[m*N+i+m] * M[(m+i+1)*N+m+k];
-            }
-            M[m*N+m+k] = cbrt(element);
-        });
+    // One parallel_for per diagonal on the selected backend
+    auto compute = [&](auto &pf){
+        for (uint64_t k = 1; k < N; k++){
+            wavefront::ParallelDiagonal(pf, schedule, N-k, k, W, [&](const long m){
+                M.Store(m, k, wavefront::ComputeElement<wavefront::ScalarDot>(M, m, k));
+            });
+        }
+    };
+    if(schedule.backend == wavefront::Schedule::kStealing){
+        wavefront::StealingPool pool(W);
+        compute(pool);
+    } else {
+        ff::ParallelFor pf(W, schedule.spinwait, schedule.spinbarrier);
+        compute(pf);
     }
 
     #ifdef DEBUG
-        SaveMatrixToFile(&M, N, "matrix_pf_results.txt");
+        wavefront::SaveMatrixToFile(M, "matrix_pf_results.txt");
     #endif
     ff::ffTime(ff::STOP_TIME);
     std::cout << "Time passed to calculate the wavefront: " << ff::ffTime(ff::GET_TIME)/1000.0 << " seconds" << std::endl;
@@ -0,0 +1,65 @@
+#include <limits>
+#include <chrono>
+#include <iostream>
+
+
+#include <ff/ff.hpp>
+#include <ff/farm.hpp>
+#include <ff/parallel_for.hpp>
+
+#include "wavefront/wavefront.hpp"
+
+//#define DEBUG
+
+using Matrix = wavefront::PackedDiagonal<double>;
+// Dot products of a diagonal block are collected first, then their cube roots are taken in SIMD
+using Kernel = wavefront::BatchCbrt<wavefront::DefaultDot>;
+
+int main(int argc, char* argv[]){
+    // N, W
+    if (argc != 3) {
+        std::cout << "Usage: " << argv[0] << "N (Size N*N) W (Workers)" << std::endl;
+        return -1;
+    }
+
+    const uint64_t N = std::strtoull(argv[1], nullptr, 10);
+    const uint64_t W = std::strtoull(argv[2], nullptr, 10);
+    if(W == 0 || W > std::numeric_limits<uint16_t>::max()){
+        std::cout << "The number of workers must be between 1 and " << std::numeric_limits<uint16_t>::max() << std::endl;
+        return -1;
+    }
+
+    // Create and fill the matrix
+    // Process to create the matrix
+    auto start = std::chrono::high_resolution_clock::now();
+
+    Matrix M(N);
+    // Fill the matrix
+    wavefront::FillMatrix(M);
+    #ifdef DEBUG
+        wavefront::SaveMatrixToFile(M, "matrix_pf_packed_normal.txt");
+    #endif
+    auto stop = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> passed_time = stop - start;
+    std::cout << "Matrix created and filled in: " << passed_time.count() << " seconds" << std::endl;
+
+    // Start the timer
+    ff::ffTime(ff::START_TIME);
+
+    ff::ParallelFor pf(W);
+    for (uint64_t k = 1; k < N; k++){
+        // One contiguous, cache-line aligned chunk of the k-th diagonal per worker
+        long grain = wavefront::DiagonalGrain<double>(N-k, W);
+        pf.parallel_for_idx(0, N-k, 1, grain, [&](const long begin, const long end, const int){
+            wavefront::ComputeDiagonal<Kernel>(M, k, begin, end);
+        });
+    }
+
+    #ifdef DEBUG
+        wavefront::SaveMatrixToFile(M, "matrix_pf_packed_results.txt");
+    #endif
+    ff::ffTime(ff::STOP_TIME);
+    std::cout << "Time passed to calculate the wavefront: " << ff::ffTime(ff::GET_TIME)/1000.0 << " seconds" << std::endl;
+    return 0;
+
+}
@@ -1,48 +1,11 @@
-#include <cmath>
-#include <vector>
 #include <chrono>
-#include <iomanip>
-#include <fstream>
 #include <iostream>
 
+#include "wavefront/wavefront.hpp"
+
 //#define DEBUG
 
-using vector_d = std::vector<double>;
-
-// FillMatrix
-/*!
-    \name FillMatrix
-    \brief Fill the matrix M with the values
-    \note Fill the matrix M with the values
-*/
-vector_d* FillMatrix(vector_d *M, uint16_t N){
-    // Fill the diagonal elements (i,j) (where i == j) with (m+1)/N
-    for(int m = 0; m < N; m++){
-        (*M)[m*N+m] = static_cast<double>(m+1)/N; // M[m][m] = (m+1)/N
-    }
-    return M;
-}
-
-/*!
-    \name SaveMatrixPtrToFile
-    \param M vector_d M
-    \param N uint16_t N
-    \param filename string filename
-    \brief Save the matrix M to a file
-    \note Save the matrix M to a file with the name filename
-*/
-void SaveMatrixToFile(vector_d *M, uint16_t N, std::string filename){
-    std::ofstream file;
-    file.open(filename);
-    file << std::fixed << std::setprecision(6);
-    for(int i = 0; i < N; i++){
-        for(int j = 0; j < N; j++){
-            file << (*M)[i*N+j] << " ";  // M[i][j]
-        }
-        file << std::endl;
-    }
-    file.close();
-}
+using Matrix = wavefront::RowMajor<double>;
 
 
 int main(int argc, char* argv[]){
@@ -52,16 +15,16 @@ int main(int argc, char* argv[]){
         return -1;
     }
 
-    const uint16_t N = atoi(argv[1]);
+    const uint64_t N = std::strtoull(argv[1], nullptr, 10);
 
     // Process to create the matrix
     auto start = std::chrono::high_resolution_clock::now();
 
-    vector_d M = vector_d(N*N, 0.0);
+    Matrix M(N);
     // Fill the matrix
-    FillMatrix(&M, N);
-    #ifdef DEBUG-
-        SaveMatrixToFile(&M, N, "matrix_seq_normal.txt");
+    wavefront::FillMatrix(M);
+    #ifdef DEBUG
+        wavefront::SaveMatrixToFile(M, "matrix_seq_normal.txt");
     #endif
     auto stop = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> passed_time = stop - start;
@@ -70,18 +33,10 @@ int main(int argc, char* argv[]){
     //Wavefront sequential
     auto start_wavefront = std::chrono::high_resolution_clock::now();
 
-    for (int k = 1; k < N; k++){
-        for(int m = 0; m < N-k; m++){
-            double element = 0.0;
-            for (int i = 0; i < k; i++){
-                element += M[m*N+i+m] * M[(m+i+1)*N+m+k];
-            }
-            M[m*N+m+k] = cbrt(element);
-        }
-    }
+    wavefront::ComputeWavefront<wavefront::ScalarDot>(M);
 
     #ifdef DEBUG
-        SaveMatrixToFile(&M, N, "matrix_seq_results.txt");
+        wavefront::SaveMatrixToFile(M, "matrix_seq_results.txt");
     #endif
     auto stop_wavefront = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> elapsed_time = stop_wavefront - start_wavefront;
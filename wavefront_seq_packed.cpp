@@ -0,0 +1,47 @@
+#include <chrono>
+#include <iostream>
+
+#include "wavefront/wavefront.hpp"
+
+//#define DEBUG
+
+using Matrix = wavefront::PackedDiagonal<double>;
+// Dot products of a diagonal block are collected first, then their cube roots are taken in SIMD
+using Kernel = wavefront::BatchCbrt<wavefront::DefaultDot>;
+
+
+int main(int argc, char* argv[]){
+    // N
+    if (argc != 2) {
+        std::cout << "Usage: " << argv[0] << "N (Size N*N)" << std::endl;
+        return -1;
+    }
+
+    const uint64_t N = std::strtoull(argv[1], nullptr, 10);
+
+    // Process to create the matrix
+    auto start = std::chrono::high_resolution_clock::now();
+
+    Matrix M(N);
+    // Fill the matrix
+    wavefront::FillMatrix(M);
+    #ifdef DEBUG
+        wavefront::SaveMatrixToFile(M, "matrix_seq_packed_normal.txt");
+    #endif
+    auto stop = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> passed_time = stop - start;
+    std::cout << "Matrix created and filled in: " << passed_time.count() << " seconds" << std::endl;
+
+    //Wavefront sequential
+    auto start_wavefront = std::chrono::high_resolution_clock::now();
+
+    wavefront::ComputeWavefront<Kernel>(M);
+
+    #ifdef DEBUG
+        wavefront::SaveMatrixToFile(M, "matrix_seq_packed_results.txt");
+    #endif
+    auto stop_wavefront = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed_time = stop_wavefront - start_wavefront;
+    std::cout << "Time passed to calculate the wavefront: " << elapsed_time.count() << " seconds" << std::endl;
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include <string>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <iostream>
+
+#include "wavefront/numa.hpp"
+#include "wavefront/barrier.hpp"
+#include "wavefront/wavefront.hpp"
+
+//#define DEBUG
+
+using Matrix = wavefront::RowMajorMirror<double>;
+
+/*!
+    \name DiagonalWorker
+    \param M matrix
+    \param barrier barrier shared by the W threads
+    \param id thread index in [0, W)
+    \param W number of threads
+    \param pin pin the thread to its core
+    \brief Compute the id-th static block of every diagonal, then wait for the others
+*/
+void DiagonalWorker(Matrix &M, wavefront::SpinBarrier &barrier, uint64_t id, uint64_t W, bool pin){
+    if(pin){
+        wavefront::PinThread(id);
+    }
+    const uint64_t N = M.N;
+    bool sense = false;
+    for(uint64_t k = 1; k < N; k++){
+        const uint64_t begin = (N-k)*id/W;
+        const uint64_t end = (N-k)*(id+1)/W;
+        wavefront::ComputeDiagonal<wavefront::DefaultDot>(M, k, begin, end);
+        barrier.Wait(sense);
+    }
+}
+
+int main(int argc, char* argv[]){
+    // N, W, NUMA options
+    wavefront::NumaPolicy policy = wavefront::NumaPolicy::kNone;
+    bool pin = false;
+    bool valid = argc >= 3;
+    for(int i = 3; i < argc && valid; i++){
+        std::string option = argv[i];
+        if(option == "--numa=none"){
+            policy = wavefront::NumaPolicy::kNone;
+        } else if(option == "--numa=firsttouch"){
+            policy = wavefront::NumaPolicy::kFirstTouch;
+        } else if(option == "--numa=interleave"){
+            policy = wavefront::NumaPolicy::kInterleave;
+        } else if(option == "--pin"){
+            pin = true;
+        } else {
+            valid = false;
+        }
+    }
+    if (!valid) {
+        std::cout << "Usage: " << argv[0] << "N (Size N*N) W (Workers) [--numa=none|firsttouch|interleave] [--pin] (firsttouch implies --pin)" << std::endl;
+        return -1;
+    }
+
+    const uint64_t N = std::strtoull(argv[1], nullptr, 10);
+    const uint64_t W = std::strtoull(argv[2], nullptr, 10);
+
+    if(W == 0){
+        std::cout << "The number of workers must be positive" << std::endl;
+        return -1;
+    }
+    #if !defined(WAVEFRONT_NUMA)
+        if(policy == wavefront::NumaPolicy::kInterleave){
+            std::cout << "--numa=interleave needs a build with -DWAVEFRONT_NUMA and libnuma (make numa)" << std::endl;
+            return -1;
+        }
+    #endif
+    if(policy == wavefront::NumaPolicy::kInterleave && !wavefront::NumaAvailable()){
+        std::cout << "Warning: libnuma reports no NUMA support, the pages are not interleaved" << std::endl;
+    }
+    // The touching threads must run where the workers will, otherwise the placement is random
+    if(policy == wavefront::NumaPolicy::kFirstTouch){
+        pin = true;
+    }
+
+    // Create and fill the matrix
+    // Process to create the matrix
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // Untouched pages, placed by FirstTouch or interleaved depending on --numa
+    Matrix M(N, wavefront::PageAllocator<double>(policy));
+    if(policy == wavefront::NumaPolicy::kFirstTouch){
+        // Row block id goes to worker id's node. That matches the rows worker id writes on the
+        // early diagonals only: its slice (N-k)*id/W moves towards the first rows as k grows and
+        // the mirror element lands in row m+k, so the late diagonals also touch remote pages
+        wavefront::FirstTouch(M, W, pin);
+    }
+    // Fill the matrix
+    wavefront::FillMatrix(M);
+    #ifdef DEBUG
+        wavefront::SaveMatrixToFile(M, "matrix_threads_normal.txt");
+    #endif
+    auto stop = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> passed_time = stop - start;
+    std::cout << "Matrix created and filled in: " << passed_time.count() << " seconds" << std::endl;
+
+    // Start the timer
+    auto start_wavefront = std::chrono::high_resolution_clock::now();
+
+    // The main thread is worker 0, the others live for the whole wavefront
+    wavefront::SpinBarrier barrier(W);
+    std::vector<std::thread> threads;
+    for(uint64_t id = 1; id < W; id++){
+        threads.emplace_back(DiagonalWorker, std::ref(M), std::ref(barrier), id, W, pin);
+    }
+    DiagonalWorker(M, barrier, 0, W, pin);
+    for(auto &thread : threads){
+        thread.join();
+    }
+
+    #ifdef DEBUG
+        wavefront::SaveMatrixToFile(M, "matrix_threads_results.txt");
+    #endif
+    auto stop_wavefront = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed_time = stop_wavefront - start_wavefront;
+    std::cout << "Time passed to calculate the wavefront: " << elapsed_time.count() << " seconds" << std::endl;
+    return 0;
+}